@@ -0,0 +1,156 @@
+// bench/microbench.hpp
+// Minimal header-only microbenchmark harness in the style of Google
+// Benchmark: a benchmark is a function of a BenchState that does its setup,
+// then loops `while(state.keep_running())` over the code being timed. The
+// runner repeats it with more iterations until it runs for at least
+// min_time, then reports per-iteration wall and CPU time. Results print as
+// a table, or as JSON (Google Benchmark's layout, so its compare tooling
+// reads it) or CSV for tracking between versions.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+struct BenchState {
+    size_t arg = 0;        // problem size for this run
+    size_t iterations = 0; // completed so far
+    size_t max_iterations = 1;
+    double items = 0;      // items processed in total, for items/s (optional)
+
+    // true while more timed iterations are wanted; the first call starts the clock
+    bool keep_running(){
+        if(iterations == 0 && !running) start();
+        if(iterations < max_iterations){ iterations++; return true; }
+        stop();
+        return false;
+    }
+    // exclude per-iteration setup (e.g. rebuilding spent state) from the timing
+    void pause(){ stop(); }
+    void resume(){ start(); }
+
+    double real_ns = 0, cpu_ns = 0;
+private:
+    bool running = false;
+    chrono::steady_clock::time_point t0;
+    clock_t c0 = 0;
+    void start(){ running = true; t0 = chrono::steady_clock::now(); c0 = clock(); }
+    void stop(){
+        if(!running) return;
+        running = false;
+        real_ns += chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+        cpu_ns += (double)(clock() - c0) * 1e9 / CLOCKS_PER_SEC;
+    }
+};
+
+struct BenchCase {
+    string name;
+    function<void(BenchState&)> fn;
+    vector<size_t> args; // one run per arg, reported as name/arg
+};
+struct BenchResult {
+    string name;
+    size_t iterations;
+    double real_ns, cpu_ns, items_per_second; // per iteration; items/s 0 when not set
+};
+
+// 10, 100, ... up to hi
+inline vector<size_t> decades(size_t lo, size_t hi){
+    vector<size_t> v;
+    for(size_t n = lo; n <= hi; n *= 10) v.push_back(n);
+    return v;
+}
+
+// runs one case at one arg: start with 1 iteration and grow (predicting from
+// the last run, at most 10x per step) until a run lasts min_time seconds
+inline BenchResult run_bench(const BenchCase& bc, size_t arg, double min_time){
+    size_t iters = 1;
+    for(;;){
+        BenchState st;
+        st.arg = arg; st.max_iterations = iters;
+        bc.fn(st);
+        double secs = st.real_ns / 1e9;
+        if(secs >= min_time || iters >= 1000000000){
+            size_t n = max<size_t>(st.iterations, 1);
+            return {bc.name + "/" + to_string(arg), n, st.real_ns / n, st.cpu_ns / n,
+                    st.items > 0 && st.real_ns > 0 ? st.items / (st.real_ns / 1e9) : 0};
+        }
+        double grow = secs > 0 ? min_time * 1.4 / secs : 10;
+        iters = (size_t)max<double>(iters + 1, min(iters * 10.0, iters * grow));
+    }
+}
+
+inline void print_header(ostream& os){
+    os << left << setw(44) << "benchmark" << right << setw(12) << "iterations" << setw(16) << "real ns/iter"
+       << setw(16) << "cpu ns/iter" << setw(14) << "items/s" << "\n";
+}
+inline void print_row(ostream& os, const BenchResult& r){
+    os << left << setw(44) << r.name << right << setw(12) << r.iterations << fixed << setprecision(1)
+       << setw(16) << r.real_ns << setw(16) << r.cpu_ns << setprecision(0) << setw(14) << r.items_per_second << "\n";
+    os.unsetf(ios::floatfield);
+}
+inline void write_csv(ostream& os, const vector<BenchResult>& rs){
+    os << "name,iterations,real_time,cpu_time,time_unit,items_per_second\n" << setprecision(10);
+    for(auto &r: rs) os << r.name << "," << r.iterations << "," << r.real_ns << "," << r.cpu_ns << ",ns," << r.items_per_second << "\n";
+}
+// context: extra string fields, e.g. the SIMD kernel set
+inline void write_json(ostream& os, const vector<BenchResult>& rs, const vector<pair<string,string>>& context){
+    time_t now = time(nullptr);
+    char date[32]; strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    os << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n    \"num_cpus\": " << thread::hardware_concurrency()
+#ifdef NDEBUG
+       << ",\n    \"library_build_type\": \"release\"";
+#else
+       << ",\n    \"library_build_type\": \"debug\"";
+#endif
+    for(auto &kv: context) os << ",\n    \"" << kv.first << "\": \"" << kv.second << "\"";
+    os << "\n  },\n  \"benchmarks\": [" << setprecision(10);
+    for(size_t k=0;k<rs.size();++k){
+        const BenchResult &r = rs[k];
+        os << (k ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"run_name\": \"" << r.name
+           << "\", \"run_type\": \"iteration\", \"iterations\": " << r.iterations << ", \"real_time\": " << r.real_ns
+           << ", \"cpu_time\": " << r.cpu_ns << ", \"time_unit\": \"ns\"";
+        if(r.items_per_second > 0) os << ", \"items_per_second\": " << r.items_per_second;
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+// Command line shared by bench programs:
+//   --filter REGEX   only names (name/arg) matching REGEX
+//   --min-time S     seconds per measurement (default 0.2)
+//   --max-n N        skip args above N
+//   --format F       stdout as console (default), json or csv
+//   --out FILE       also write the results to FILE (CSV if it ends in .csv, else JSON)
+inline int bench_main(int argc, char** argv, const vector<BenchCase>& cases, const vector<pair<string,string>>& context){
+    string filter = ".*", format = "console", out_path;
+    double min_time = 0.2;
+    size_t max_n = SIZE_MAX;
+    for(int i=1;i<argc;++i){
+        string a = argv[i];
+        if(a=="--filter" && i+1<argc) filter = argv[++i];
+        else if(a=="--min-time" && i+1<argc) min_time = atof(argv[++i]);
+        else if(a=="--max-n" && i+1<argc) max_n = stoull(argv[++i]);
+        else if(a=="--format" && i+1<argc) format = argv[++i];
+        else if(a=="--out" && i+1<argc) out_path = argv[++i];
+        else {
+            cerr << "Usage: " << argv[0] << " [--filter REGEX] [--min-time S] [--max-n N] [--format console|json|csv] [--out FILE]\n";
+            return 1;
+        }
+    }
+    regex re(filter);
+    vector<BenchResult> results;
+    if(format == "console") print_header(cout);
+    for(auto &bc: cases) for(size_t arg: bc.args){
+        if(arg > max_n || !regex_search(bc.name + "/" + to_string(arg), re)) continue;
+        results.push_back(run_bench(bc, arg, min_time));
+        if(format == "console") print_row(cout, results.back()), cout << flush; // rows as they finish
+    }
+    if(format == "json") write_json(cout, results, context);
+    else if(format == "csv") write_csv(cout, results);
+    if(!out_path.empty()){
+        ofstream out(out_path);
+        if(!out){ cerr << "Cannot create " << out_path << "\n"; return 1; }
+        bool csv = out_path.size() >= 4 && out_path.compare(out_path.size()-4, 4, ".csv") == 0;
+        if(csv) write_csv(out, results); else write_json(out, results, context);
+    }
+    return 0;
+}
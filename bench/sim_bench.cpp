@@ -0,0 +1,178 @@
+// bench/sim_bench.cpp
+// Microbenchmarks for the simulator and analyzer hot paths on synthetic
+// workloads of 10 to 10^6 processes (or series points):
+//   step/<policy>/N          one event of a running simulation (items/s = events/s)
+//   pick_next/<policy>/N     pick from a run queue of N and requeue the job
+//   total_mem/N              memory sample with N live processes
+//   moving_avg/N             Analyzer::moving_avg over N points (batch reference)
+//   linear_regression_offset/N  Analyzer::linear_regression_offset over N points (batch reference)
+//   sliding_windows/N        SlidingWindows::add + mean, one new sample into an N-point window
+//   incremental_regression/N IncrementalRegression::add + result, one new sample, N-point fit
+//   analyze_and_report/{quiet,full}/N  one analysis tick, mid-run, N processes
+// Compile: g++ -std=c++17 bench/sim_bench.cpp -O2 -pthread -o sim_bench.exe
+// Run: .\sim_bench.exe [--filter REGEX] [--min-time S] [--max-n N] [--format console|json|csv] [--out FILE]
+//      e.g. --format json --out before.json, then compare with a later build's run
+
+#include <bits/stdc++.h>
+using namespace std;
+#define AIPO_NO_MAIN
+#include "../src/aipo_simulator.cpp"
+#include "microbench.hpp"
+
+static volatile double sink = 0;
+
+// text report sink that formats everything and keeps nothing
+struct NullBuf : streambuf {
+    char buf[4096];
+    NullBuf(){ setp(buf, buf + sizeof buf); }
+    int overflow(int c) override { setp(buf, buf + sizeof buf); return traits_type::not_eof(c); }
+};
+
+// n jobs with arrivals spread evenly over [0, spread_ms] (0: all at t=0).
+// progressed: each job has already run part of its burst, as mid-run.
+static ProcessTable synthetic_table(size_t n, double spread_ms, bool progressed){
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> burst(10, 400), mem(1000, 200000), io(0, 0.9), u(0, 1);
+    ProcessTable t;
+    t.reserve(n);
+    for(size_t i=0;i<n;++i){
+        Process p((int)i+1, n > 1 ? spread_ms * i / (n-1) : 0, burst(rng), mem(rng), io(rng));
+        if(progressed){ p.cpu_consumed = p.burst * u(rng) * 0.95; p.remaining = p.burst - p.cpu_consumed; }
+        t.push_back(p);
+    }
+    return t;
+}
+
+template<class Policy>
+static void configure_quiet(Simulator<Policy>& sim, Verbosity v, ostream* report){
+    SimOptions opt;
+    opt.csv_path = ""; opt.cores_csv_path = ""; // no files: I/O is not what is measured here
+    opt.verbosity = v; opt.report = report;
+    sim.configure(opt);
+}
+
+template<class Policy>
+static void bm_step(BenchState& st){
+    ProcessTable table = synthetic_table(st.arg, st.arg * 2.0, false); // overloaded: queues grow with N
+    auto sim = make_unique<Simulator<Policy>>();
+    configure_quiet(*sim, VERB_QUIET, &cout);
+    sim->load(table); sim->begin_run();
+    while(st.keep_running()){
+        if(sim->all_done() || !sim->step()){ // run over: start again, untimed
+            st.pause(); sim->load(table); sim->begin_run(); st.resume();
+        }
+    }
+    st.items = (double)st.iterations;
+}
+
+template<class Policy>
+static void bm_pick_next(BenchState& st){
+    auto sim = make_unique<Simulator<Policy>>();
+    configure_quiet(*sim, VERB_QUIET, &cout);
+    sim->load(synthetic_table(st.arg, 0, false));
+    sim->admit_arrivals(); // all N queued on core 0, none running
+    while(st.keep_running()){
+        int i = sim->pick_next(0);
+        sim->queues[0].requeue(sim->procs, i, sim->quantum, true);
+        sim->set_queued(0, +1);
+    }
+    st.items = (double)st.iterations;
+}
+
+static void bm_total_mem(BenchState& st){
+    auto sim = make_unique<Simulator<SrtfPolicy>>();
+    configure_quiet(*sim, VERB_QUIET, &cout);
+    sim->load(synthetic_table(st.arg, 0, false));
+    sim->begin_run();
+    while(st.keep_running()) sink = sink + sim->total_mem();
+}
+
+static vector<SeriesPoint> synthetic_series(size_t n){
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> u(0, 200000);
+    vector<SeriesPoint> s(n);
+    for(size_t i=0;i<n;++i) s[i] = {(double)i, u(rng)}; // one point per ms
+    return s;
+}
+
+static void bm_moving_avg(BenchState& st){
+    vector<SeriesPoint> s = synthetic_series(st.arg);
+    double window = st.arg / 2.0; // the newest half of the series
+    while(st.keep_running()) sink = sink + Analyzer::moving_avg(s, window);
+    st.items = (double)st.iterations * (st.arg / 2); // points averaged
+}
+
+static void bm_regression(BenchState& st){
+    vector<SeriesPoint> s = synthetic_series(st.arg);
+    while(st.keep_running()) sink = sink + Analyzer::linear_regression_offset(s, (int)st.arg).first;
+    st.items = (double)st.iterations * st.arg;
+}
+
+// what an analysis tick reads: the window is full, so each add also evicts
+static void bm_sliding_windows(BenchState& st){
+    vector<SeriesPoint> s = synthetic_series(st.arg);
+    SlidingWindows w;
+    int id = w.add_window(st.arg - 1.0); // one point per ms: exactly N points inside
+    for(auto &p: s) w.add(p);
+    double t = (double)st.arg;
+    size_t k = 0;
+    while(st.keep_running()){
+        w.add({t++, s[k].value});
+        if(++k == s.size()) k = 0;
+        sink = sink + w.mean(id);
+    }
+    st.items = (double)st.iterations;
+}
+
+static void bm_incremental_regression(BenchState& st){
+    vector<SeriesPoint> s = synthetic_series(st.arg);
+    IncrementalRegression r(st.arg);
+    for(auto &p: s) r.add(p);
+    double t = (double)st.arg;
+    size_t k = 0;
+    while(st.keep_running()){
+        r.add({t++, s[k].value});
+        if(++k == s.size()) k = 0;
+        sink = sink + r.result().first;
+    }
+    st.items = (double)st.iterations;
+}
+
+static void bm_analyze(BenchState& st, Verbosity v){
+    NullBuf nb;
+    ostream report(&nb);
+    auto sim = make_unique<Simulator<SrtfPolicy>>();
+    configure_quiet(*sim, v, &report);
+    sim->load(synthetic_table(st.arg, 0, true));
+    sim->begin_run();
+    double t = 0;
+    while(st.keep_running()) sim->analyze_and_report(t += sim->analysis_interval);
+}
+
+int main(int argc, char** argv){
+    vector<size_t> sizes = decades(10, 1000000);
+    vector<BenchCase> cases = {
+        {"step/fcfs", bm_step<FcfsPolicy>, sizes},
+        {"step/rr", bm_step<RoundRobinPolicy>, sizes},
+        {"step/srtf", bm_step<SrtfPolicy>, sizes},
+        {"step/priority", bm_step<PriorityPolicy>, sizes},
+        {"step/mlfq", bm_step<MlfqPolicy>, sizes},
+        {"step/cfs", bm_step<CfsPolicy>, sizes},
+        {"step/edf", bm_step<EdfPolicy>, sizes},
+        {"pick_next/fcfs", bm_pick_next<FcfsPolicy>, sizes},
+        {"pick_next/rr", bm_pick_next<RoundRobinPolicy>, sizes},
+        {"pick_next/srtf", bm_pick_next<SrtfPolicy>, sizes},
+        {"pick_next/priority", bm_pick_next<PriorityPolicy>, sizes},
+        {"pick_next/mlfq", bm_pick_next<MlfqPolicy>, sizes},
+        {"pick_next/cfs", bm_pick_next<CfsPolicy>, sizes},
+        {"pick_next/edf", bm_pick_next<EdfPolicy>, sizes},
+        {"total_mem", bm_total_mem, sizes},
+        {"moving_avg", bm_moving_avg, sizes},
+        {"linear_regression_offset", bm_regression, sizes},
+        {"sliding_windows", bm_sliding_windows, sizes},
+        {"incremental_regression", bm_incremental_regression, sizes},
+        {"analyze_and_report/quiet", [](BenchState& st){ bm_analyze(st, VERB_QUIET); }, sizes},
+        {"analyze_and_report/full", [](BenchState& st){ bm_analyze(st, VERB_FULL); }, sizes},
+    };
+    return bench_main(argc, argv, cases, {{"simd", simd().name}});
+}
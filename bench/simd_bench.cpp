@@ -0,0 +1,63 @@
+// bench/simd_bench.cpp
+// Times the analyzer reduction kernels (scalar vs SSE2 vs AVX2) on a
+// synthetic series, and checks the variants agree.
+// Compile: g++ -std=c++17 bench/simd_bench.cpp -O2 -o simd_bench.exe
+// Run: .\simd_bench.exe [points]   (default 1000000)
+
+#include <bits/stdc++.h>
+using namespace std;
+#include "../src/simd_kernels.hpp"
+
+template<class F>
+static double time_ns(F f, int reps){
+    auto t0 = chrono::steady_clock::now();
+    for(int r=0;r<reps;++r) f();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / reps;
+}
+
+int main(int argc, char** argv){
+    size_t n = argc>1 ? stoul(argv[1]) : 1000000;
+    int reps = (int)max<size_t>(3, 200000000 / max<size_t>(n, 1) / 8);
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> u(0, 200);
+    vector<SeriesPoint> s(n);
+    double t=0; for(auto &p: s){ t += 10; p = {t, u(rng)*1000}; }
+
+    vector<const SimdKernels*> variants = {&scalar_kernels()};
+#ifdef AIPO_X86
+    variants.push_back(&sse2_kernels());
+    if(cpu_has_avx2()) variants.push_back(&avx2_kernels());
+#endif
+
+    cout << "n=" << n << " reps=" << reps << " (ns per call, speedup vs scalar)\n";
+    cout << left << setw(16) << "kernel";
+    for(auto v: variants) cout << setw(22) << v->name;
+    cout << "\n";
+
+    double ref[4]; scalar_kernels().reg_sums(s.data(), n, s[0].time, ref);
+    double ref_sum = scalar_kernels().sum_values(s.data(), n);
+    volatile double sink = 0;
+
+    auto row = [&](const char* name, auto run){
+        cout << setw(16) << name;
+        double base = 0;
+        for(auto v: variants){
+            double ns = time_ns([&]{ run(*v); }, reps);
+            if(base == 0) base = ns;
+            ostringstream cell; cell << fixed << setprecision(0) << ns << " (" << setprecision(2) << base/ns << "x)";
+            cout << setw(22) << cell.str();
+        }
+        cout << "\n";
+    };
+    row("reg_sums", [&](const SimdKernels& k){ double o[4]; k.reg_sums(s.data(), n, s[0].time, o); sink = sink + o[3]; });
+    row("sum_values", [&](const SimdKernels& k){ sink = sink + k.sum_values(s.data(), n); });
+
+    bool ok = true;
+    for(auto v: variants){
+        double o[4]; v->reg_sums(s.data(), n, s[0].time, o);
+        for(int j=0;j<4;++j) ok &= fabs(o[j] - ref[j]) <= 1e-9 * max(1.0, fabs(ref[j]));
+        ok &= fabs(v->sum_values(s.data(), n) - ref_sum) <= 1e-9 * max(1.0, fabs(ref_sum));
+    }
+    cout << "variants agree: " << (ok ? "yes" : "NO") << "\n";
+    return ok ? 0 : 1;
+}
@@ -2,37 +2,68 @@
 // src/aipo_simulator.cpp
 // Patched AI-powered Performance Analyzer for OS Processes
 // Adds: stable regression, clamped forecasts, robust analysis loop, CSV export
-// Compile: g++ -std=c++17 src/aipo_simulator.cpp -O2 -o aipo_sim.exe
+// Compile: g++ -std=c++17 src/aipo_simulator.cpp -O2 -pthread -o aipo_sim.exe
 // Run: .\aipo_sim.exe traces\sample_burst.txt   (Windows PowerShell)
+//      .\aipo_sim.exe --policy rr traces\sample_burst.txt   (fcfs|rr|srtf|priority|mlfq|cfs|edf)
+//      .\aipo_sim.exe convert traces\sample_burst.txt burst.bin   (binary trace, then run on burst.bin)
+//      .\aipo_sim.exe generate --count 1000000 --seed 7 big.txt big.bin
+//      .\aipo_sim.exe bench --count 1000000 --repeat 3 --out bench.csv
+//      .\aipo_sim.exe sweep --quantum 5:20:5 --horizon 250,500 traces\sample_burst.txt
 
 #include <bits/stdc++.h>
 using namespace std;
+#include "process.hpp"
+#include "sched_policy.hpp"
+#include "trace_reader.hpp"
+#include "simd_kernels.hpp"
+#include "streaming_stats.hpp"
+#include "time_series.hpp"
+#include "thread_pool.hpp"
+#include "event_queue.hpp"
+#include "csv_writer.hpp"
+#include "process_index.hpp"
+#include "workload_gen.hpp"
+#include "forecast.hpp"
+#include "instrument.hpp"
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
 
-struct Process {
-    int pid;
-    double arrival; // ms
-    double burst;   // ms total work
-    double remaining;
-    double mem_kb;  // simulated memory footprint
-    double io_weight; // 0..1
-    double start_time, finish_time;
-    double cpu_consumed; // ms
-    Process(int id=0,double a=0,double b=0,double m=0,double io=0)
-      :pid(id),arrival(a),burst(b),remaining(b),mem_kb(m),io_weight(io),
-       start_time(-1),finish_time(-1),cpu_consumed(0){}
-};
+// Arrival calendar: process indices sorted by (arrival, index) once at load(),
+// consumed through a cursor. Everything before the cursor has arrived.
+struct ArrivalCalendar {
+    vector<int> order;
+    size_t cursor = 0;
 
-struct SeriesPoint { double time; double value; };
+    void build(const ProcessTable& procs){
+        order.resize(procs.size());
+        iota(order.begin(), order.end(), 0);
+        const vector<double>& arrival = procs.arrival;
+        stable_sort(order.begin(), order.end(),
+            [&](int a, int b){ return arrival[a] < arrival[b]; });
+        cursor = 0;
+    }
+    bool pending() const { return cursor < order.size(); }
+    int peek() const { return order[cursor]; }
+    int take(){ return order[cursor++]; }
+    // earliest arrival not yet consumed, or 1e18 when the calendar is exhausted
+    double next_time(const ProcessTable& procs) const { return pending() ? procs.arrival[peek()] : 1e18; }
+};
 
 struct Analyzer {
     // moving average over window_ms of last points
     static double moving_avg(const vector<SeriesPoint>& s, double window_ms) {
         if(s.empty()) return 0;
         double now = s.back().time;
-        double sum=0; int cnt=0;
-        for(int i=(int)s.size()-1;i>=0;--i){
-            if(now - s[i].time <= window_ms){ sum+=s[i].value; cnt++; } else break;
-        }
+        // times never decrease, so the window is a suffix: binary search its start
+        auto first = partition_point(s.begin(), s.end(),
+            [&](const SeriesPoint& p){ return now - p.time > window_ms; });
+        size_t start = first - s.begin(), cnt = s.size() - start;
+        if(cnt >= SIMD_MIN_POINTS) return simd().sum_values(&s[start], cnt) / cnt;
+        double sum=0;
+        for(size_t i=s.size();i-- > start;) sum+=s[i].value;
         return cnt? sum/cnt : 0.0;
     }
     // stable linear regression: uses time-offset (small x), returns (slope, intercept)
@@ -46,10 +77,16 @@ struct Analyzer {
         int start = (int)s.size() - n;
         double t0 = s[start].time;
         double sx=0, sy=0, sxx=0, sxy=0;
-        for(int i=start;i<s.size();++i){
-            double x = s[i].time - t0; // offset time
-            double y = s[i].value;
-            sx += x; sy += y; sxx += x*x; sxy += x*y;
+        if(n >= (int)SIMD_MIN_POINTS){
+            double sums[4];
+            simd().reg_sums(&s[start], n, t0, sums);
+            sx = sums[0]; sy = sums[1]; sxx = sums[2]; sxy = sums[3];
+        } else {
+            for(int i=start;i<s.size();++i){
+                double x = s[i].time - t0; // offset time
+                double y = s[i].value;
+                sx += x; sy += y; sxx += x*x; sxy += x*y;
+            }
         }
         double denom = n * sxx - sx * sx;
         if(fabs(denom) < 1e-9) {
@@ -68,171 +105,764 @@ struct Analyzer {
     }
 };
 
+// Everything that happens in simulated time is one of these, kept in a timer
+// wheel and handled in time order. Slice ends are split by outcome; both are
+// handled by end_slice(). Analysis ticks sort after other events at the same
+// time, so a tick sees everything that happened at its instant.
+enum EventKind { EV_ARRIVAL, EV_QUANTUM_EXPIRY, EV_COMPLETION, EV_IO_COMPLETION, EV_ANALYSIS };
+struct SimEvent {
+    EventKind kind;
+    int id; // core for slice ends, process index for I/O completions
+};
+
+// Wall time per pipeline phase, for the bench subcommand. Each lap(p)
+// charges the time since the previous lap to p, so the phases tile the run
+// with one clock read per boundary; when off, a lap is a single branch.
+enum Phase { PH_SCHED, PH_SAMPLE, PH_ANALYSIS, PH_IO, PH_COUNT };
+struct PhaseClock {
+    bool on = false;
+    double ms[PH_COUNT] = {};
+    chrono::steady_clock::time_point last;
+    void start(){ fill(ms, ms + PH_COUNT, 0.0); last = chrono::steady_clock::now(); }
+    void lap(Phase p){
+        if(!on) return;
+        auto now = chrono::steady_clock::now();
+        ms[p] += chrono::duration<double, milli>(now - last).count();
+        last = now;
+    }
+};
+
+// how much analysis text is printed per tick (see analyze_and_report)
+enum Verbosity { VERB_QUIET, VERB_BRIEF, VERB_FULL };
+
+// run-time knobs shared by every Simulator instantiation
+struct SimOptions {
+    // sampled series keep at most this many points / this much history (ms);
+    // the analysis reads incremental stats, not the raw series
+    size_t retention_points = 4096;
+    double retention_ms = 1000.0;
+    double archive_bucket_ms = 0; // > 0: keep a min/max/mean history per bucket for the whole run
+    // model parameters, swept by the sweep subcommand
+    double quantum = 10.0;              // ms, base slice handed to the policy
+    double analysis_interval = 100.0;   // ms between analysis ticks
+    double util_window_ms = 200.0;      // moving-average window for the CPU util report
+    size_t regression_points = 10;      // memory samples in the slope fit
+    double forecast_horizon_ms = 500.0; // how far ahead memory is forecast
+    ForecastParams forecast;            // reported model; every model is scored
+    int cores = 1;                      // simulated CPUs, one run queue each
+    // false: I/O is folded into the slice (a job with io_weight w does 1 - w ms
+    // of work per ms on the CPU). true: a job computes for its slice and then
+    // blocks for w / (1 - w) as long, off the CPU, until its I/O completes.
+    bool io_blocking = false;
+    // output sinks; batch runs point each instance at its own files
+    string csv_path = "analysis.csv";
+    string history_path = "analysis_history.csv";
+    string cores_csv_path = "analysis_cores.csv"; // per-core util per tick, written when cores > 1
+    ostream* report = &cout; // human-readable analysis text
+    size_t top_k = 3;                   // top CPU consumers reported per tick (text, CSV, JSON)
+    ClassRules rules;                   // hotspot and CPU/IO-bound thresholds
+    Verbosity verbosity = VERB_FULL;
+    string json_path; // non-empty: also write one JSON object per tick (JSON lines)
+    bool time_phases = false; // fill RunSummary::phase_ms (bench)
+};
+
+// returns what is wrong with the model parameters, or "" if they are usable
+inline string invalid_option(const SimOptions& opt){
+    if(!(opt.quantum > 0)) return "quantum must be > 0";
+    if(!(opt.analysis_interval > 0)) return "analysis interval must be > 0";
+    if(!(opt.util_window_ms > 0)) return "window must be > 0";
+    if(opt.regression_points < 2) return "regression points must be >= 2";
+    if(opt.cores < 1) return "cores must be >= 1";
+    if(!(opt.forecast_horizon_ms >= 0)) return "forecast horizon must be >= 0";
+    const ForecastParams &f = opt.forecast;
+    if(!(f.step_ms > 0)) return "forecast step must be > 0";
+    if(!(f.season_ms >= f.step_ms)) return "season must be at least one forecast step";
+    if(!(f.alpha > 0 && f.alpha <= 1 && f.beta > 0 && f.beta <= 1 && f.gamma > 0 && f.gamma <= 1))
+        return "smoothing factors must be in (0, 1]";
+    return "";
+}
+
+// end-of-run totals, one row of the batch/sweep summaries
+struct RunSummary {
+    size_t processes = 0, completed = 0, analysis_ticks = 0;
+    double end_time = 0, avg_turnaround = 0, peak_mem = 0;
+    // over analysis ticks: mean reported util, largest forecast, and the mean
+    // absolute error of forecasts whose horizon was reached before the run ended
+    double mean_avg_util = 0, max_forecast = 0, forecast_mae = 0;
+    int forecast_model = FC_LINEAR;
+    double model_mae[FC_COUNT] = {}; // forecast_mae of every model, the reported one included
+    size_t forecasts_checked = 0;
+    size_t hotspot_ticks = 0; // ticks reporting at least one hotspot
+    int cores = 1;
+    size_t migrations = 0;
+    double cpu_busy_pct = 0; // busy (1 - io_weight weighted) share of all cores over the run
+    size_t events = 0; // handled by step()
+    double phase_ms[PH_COUNT] = {}; // with SimOptions::time_phases
+};
+
+template<class Policy>
 struct Simulator {
-    vector<Process> procs;
+    ProcessTable procs;
     double current_time = 0.0; // ms
-    double quantum = 10.0; // ms
-    vector<SeriesPoint> cpu_util_ts; // time->util (0..100)
-    vector<SeriesPoint> mem_usage_ts; // time->mem_kb_total
+    double quantum = 10.0; // ms, base slice handed to the policy
+    double analysis_interval = 100.0; // ms
+    double forecast_horizon = 500.0; // ms
+    RingSeries cpu_util_ts; // time->util (0..100), recent window only
+    RingSeries mem_usage_ts; // time->mem_kb_total, recent window only
+    // windowed means of cpu_util_ts, updated per sample; add lengths here to report more
+    SlidingWindows util_windows;
+    double util_window_ms = 200.0;
+    int util_avg_window = util_windows.add_window(util_window_ms);
+    // least-squares fit over the last N memory samples, for the slope/forecast
+    IncrementalRegression mem_regression{10};
+    MemForecasters forecasters; // the smoothing models, fed per sample
+    int forecast_model = FC_LINEAR;
     double max_observed_mem = 0.0;
+    ArrivalCalendar arrivals;
+    // Simulated CPUs, each with its own run queue (a Policy instance). A core
+    // runs one slice at a time and its end is an event, so a step costs
+    // O(log cores) at any core count.
+    // Arrivals go to the least loaded core; a core whose queue runs dry steals
+    // from the most loaded one (a migration).
+    struct Core {
+        int running = -1;          // process index, -1 = idle
+        double start = 0, slice = 0, run = 0, weight = 0; // current slice; weight = 1 - io_weight
+        int queued = 0;
+        double busy_done = 0;      // weighted busy ms of finished slices
+        double busy_at_tick = 0;   // busy_ms() as of the last analysis tick
+        double busy_ms(double t) const { return busy_done + (running >= 0 ? weight * min(max(t - start, 0.0), run) : 0.0); }
+    };
+    int ncores = 1;
+    vector<Core> cores;
+    vector<Policy> queues;
+    // pending events; simulated time jumps from one to the next. Only the
+    // next arrival is ever queued, so streaming stays bounded.
+    TimerWheel<SimEvent> events{1.0};
+    bool arrival_scheduled = false;
+    bool io_blocking = false;
+    set<tuple<int,int,int>> core_load; // (queued, busy, core), only kept with more than one core
+    vector<int> wake; // idle cores that may have work
+    size_t migrations = 0;
+    // weighted busy time over all cores: done + running_weight * t - running_wstart
+    double busy_done_total = 0, running_weight = 0, running_wstart = 0;
+    int busy_cores = 0;
+    double sample_time = 0, sample_busy = 0; // as of the last record_sample()
+    size_t completed = 0; // processes with no work left, arrived or not
+    size_t seen = 0; // processes loaded so far (whole trace unless streaming)
+    // streaming ingestion: when set, arrivals are read from the trace as time
+    // advances and finished processes give their slot back via free_slots
+    TraceStream* stream = nullptr;
+    vector<int> free_slots;
+    // running aggregates over live processes (arrived, not finished); kept in
+    // sync on arrival and completion so sampling does not rescan procs.
+    // Build with -DAIPO_CHECK_AGGREGATES to verify them against a full recompute.
+    double live_mem = 0.0;
+    double live_busy = 0.0; // sum of (1 - io_weight)
+    int live_count = 0;
+    double sum_turnaround = 0; // over retired processes
+    size_t analysis_ticks = 0;
+    // per-tick report statistics for summary()
+    double sum_avg_util = 0, max_forecast = 0, sum_forecast_err[FC_COUNT] = {};
+    size_t forecasts_checked = 0, hotspot_ticks = 0;
+    struct OpenForecast { double time; double value[FC_COUNT]; };
+    deque<OpenForecast> open_forecasts; // every model's forecast for a time not yet reached
 
-    // CSV writer
-    ofstream csv;
+    // kept in step with cpu_consumed/remaining wherever those change
+    TopConsumers top_consumers;
+    ProcessClasses classes;
+    size_t top_k = 3;
+    vector<pair<double,int>> top_list; // this tick's top_k, (cpu_consumed, index)
 
-    void open_csv(const string &path="analysis.csv"){
-        csv.open(path);
-        csv << "time_ms,avg_cpu_util,mem_kb,slope_kb_per_ms,forecast_kb,"
-               "top1_pid,top1_cpu_ms,top2_pid,top2_cpu_ms,top3_pid,top3_cpu_ms,hotspots\n";
+    // output: analysis text goes to *out, rows to csv
+    ostream* out = &cout;
+    string csv_path = "analysis.csv";
+    AsyncCsvWriter csv;
+    string cores_csv_path;
+    AsyncCsvWriter cores_csv;
+    Verbosity verbosity = VERB_FULL;
+    string json_path;
+    AsyncCsvWriter json;
+    vector<double> core_util; // per-core util over the last tick interval
+    double last_tick = 0; // at_time of the previous analysis, for per-core util
+    size_t events_handled = 0;
+    PhaseClock phases;
+
+    void open_csv(const string &path){
+        if(!csv.open(path)) return;
+        string header = "time_ms,avg_cpu_util,mem_kb,slope_kb_per_ms,forecast_kb,";
+        for(size_t k=1;k<=top_k;++k) header += "top" + to_string(k) + "_pid,top" + to_string(k) + "_cpu_ms,";
+        csv.write((header + "hotspots\n").c_str());
     }
-    void close_csv(){ if(csv.is_open()) csv.close(); }
+    void close_csv(){ csv.close(); cores_csv.close(); json.close(); }
 
-    void load(const vector<tuple<double,double,double,double>>& jobs){
-        procs.clear(); int id=1;
-        for(auto &t: jobs) procs.emplace_back(id++, get<0>(t), get<1>(t), get<2>(t), get<3>(t));
+    void configure(const SimOptions& opt){
+        out = opt.report;
+        verbosity = opt.verbosity;
+        top_k = opt.top_k;
+        classes.rules = opt.rules;
+        json_path = opt.json_path;
+        phases.on = opt.time_phases;
+        csv_path = opt.csv_path;
+        quantum = opt.quantum;
+        analysis_interval = opt.analysis_interval;
+        forecast_horizon = opt.forecast_horizon_ms;
+        util_windows = SlidingWindows();
+        util_window_ms = opt.util_window_ms;
+        util_avg_window = util_windows.add_window(util_window_ms);
+        mem_regression = IncrementalRegression(opt.regression_points);
+        forecasters.configure(opt.forecast);
+        forecast_model = opt.forecast.model;
+        ncores = opt.cores;
+        io_blocking = opt.io_blocking;
+        cores_csv_path = opt.cores_csv_path;
+        cpu_util_ts.configure(opt.retention_points, opt.retention_ms);
+        mem_usage_ts.configure(opt.retention_points, opt.retention_ms);
+        if(opt.archive_bucket_ms > 0){
+            cpu_util_ts.enable_archive(opt.archive_bucket_ms);
+            mem_usage_ts.enable_archive(opt.archive_bucket_ms);
+        }
+    }
+
+    void load(ProcessTable table){
+        procs = move(table);
+        stream = nullptr;
+        reset_run();
+    }
+    // bounded-memory mode: only live processes stay in procs
+    void load_stream(TraceStream& ts){
+        procs.clear();
+        stream = &ts;
+        reset_run();
+    }
+    void reset_run(){
         current_time = 0.0;
         cpu_util_ts.clear();
         mem_usage_ts.clear();
+        util_windows.clear();
+        mem_regression.clear();
+        forecasters.clear();
         max_observed_mem = 0.0;
+        arrivals.build(procs);
+        cores.assign(ncores, Core());
+        queues.assign(ncores, Policy());
+        for(auto &q: queues) q.reset(procs);
+        events.clear();
+        arrival_scheduled = false;
+        core_load.clear();
+        if(ncores > 1) for(int c=0;c<ncores;++c) core_load.insert(load_key(c));
+        wake.clear();
+        migrations = 0;
+        busy_done_total = running_weight = running_wstart = 0; busy_cores = 0;
+        sample_time = sample_busy = 0;
+        live_mem = live_busy = 0.0; live_count = 0;
+        completed = 0;
+        for(double r: procs.remaining) if(r<=1e-9) completed++;
+        seen = procs.size();
+        free_slots.clear();
+        top_consumers.build(procs);
+        classes.build(procs);
+        sum_turnaround = 0;
+        analysis_ticks = 0;
+        sum_avg_util = max_forecast = 0;
+        fill(sum_forecast_err, sum_forecast_err + FC_COUNT, 0.0);
+        forecasts_checked = hotspot_ticks = 0;
+        open_forecasts.clear();
+    }
+
+    bool arrivals_pending() const { return stream ? stream->pending() : arrivals.pending(); }
+    double next_arrival_time() const { return stream ? stream->next_arrival() : arrivals.next_time(procs); }
+
+    // move every process with arrival <= current_time into the ready queue
+    void admit_arrivals(){
+        while(arrivals_pending() && next_arrival_time() <= current_time){
+            int i = stream ? take_streamed() : arrivals.take();
+            if(procs.remaining[i] <= 1e-9){ // zero-burst jobs were counted as completed at load()
+                if(stream){ completed++; release_slot(i); }
+                continue;
+            }
+            enqueue(i);
+            live_mem += procs.mem_kb[i]; live_busy += max(0.0, 1.0 - procs.io_weight[i]); live_count++;
+        }
+    }
+    int take_streamed(){
+        seen++;
+        if(free_slots.empty()){
+            phases.lap(PH_SCHED);
+            procs.push_back(stream->take());
+            phases.lap(PH_IO);
+            top_consumers.add((int)procs.size()-1, procs.cpu_consumed.back());
+            classes.update(procs, (int)procs.size()-1);
+            return (int)procs.size()-1;
+        }
+        int i = free_slots.back(); free_slots.pop_back();
+        phases.lap(PH_SCHED);
+        procs.set(i, stream->take());
+        phases.lap(PH_IO); // trace parsing
+        top_consumers.add(i, procs.cpu_consumed[i]);
+        classes.update(procs, i);
+        return i;
+    }
+    // dead slots keep pid -1 and no work, so reports and sampling skip them
+    void release_slot(int i){
+        top_consumers.remove(i, procs.cpu_consumed[i]);
+        procs.set(i, Process(-1));
+        classes.update(procs, i);
+        free_slots.push_back(i);
+    }
+    void retire(int i){
+        completed++;
+        sum_turnaround += procs.finish_time[i] - procs.arrival[i];
+        live_count--;
+        if(live_count == 0){ live_mem = live_busy = 0.0; return; } // drop accumulated rounding
+        live_mem -= procs.mem_kb[i]; live_busy -= max(0.0, 1.0 - procs.io_weight[i]);
+    }
+
+    // hands runnable process i to the least loaded core
+    void enqueue(int i){
+        int c = ncores > 1 ? get<2>(*core_load.begin()) : 0;
+        queues[c].admit(procs, i, current_time);
+        set_queued(c, +1);
+        if(cores[c].running < 0) wake.push_back(c);
+    }
+
+    tuple<int,int,int> load_key(int c) const { return {cores[c].queued, cores[c].running >= 0, c}; }
+    void set_queued(int c, int delta){
+        if(ncores > 1) core_load.erase(load_key(c));
+        cores[c].queued += delta;
+        if(ncores > 1) core_load.insert(load_key(c));
+    }
+    void set_running(int c, int idx){
+        if(ncores > 1) core_load.erase(load_key(c));
+        cores[c].running = idx;
+        if(ncores > 1) core_load.insert(load_key(c));
+    }
+
+    // removes the next process for core c from its queue, stealing from the
+    // most loaded core when c has none; step() requeues it
+    int pick_next(int c = 0){
+        AIPO_PROF_SCOPE("pick_next");
+        admit_arrivals();
+        int i = queues[c].pick(procs, current_time);
+        if(i >= 0){ set_queued(c, -1); return i; }
+        if(ncores == 1) return -1;
+        int victim = get<2>(*core_load.rbegin());
+        if(victim == c || cores[victim].queued == 0) return -1;
+        i = queues[victim].steal(procs);
+        set_queued(victim, -1);
+        migrations++;
+        queues[c].admit(procs, i, current_time);
+        return queues[c].pick(procs, current_time);
     }
 
-    int pick_next(){
-        int idx=-1; double best=1e18;
-        for(int i=0;i<procs.size();++i)
-            if(procs[i].arrival<=current_time && procs[i].remaining>1e-9)
-                if(procs[i].remaining < best){ best = procs[i].remaining; idx=i; }
-        return idx;
-    }
-
-    bool all_done(){ for(auto &p: procs) if(p.remaining>1e-9) return false; return true; }
-
-    void step(){
-        int idx = pick_next();
-        if(idx<0){
-            double tnext = 1e18;
-            for(auto &p: procs) if(p.arrival>current_time) tnext=min(tnext,p.arrival);
-            if(tnext==1e18) return; // all done
-            // jump to next arrival (idle)
-            current_time = tnext;
-            cpu_util_ts.push_back({current_time,0});
-            mem_usage_ts.push_back({current_time, total_mem()});
-            max_observed_mem = max(max_observed_mem, total_mem());
-            return;
-        }
-        Process &pr = procs[idx];
-        if(pr.start_time<0) pr.start_time = current_time;
-        double run = min(quantum, pr.remaining / max(1.0 - pr.io_weight, 1e-9)); // ensure some progress
-        if(run <= 0) run = quantum;
-        // CPU effective work is reduced by io_weight
-        double cpu_run = run * (1.0 - pr.io_weight);
+    // gives every idle core that has (or can steal) work a slice
+    void dispatch(){
+        admit_arrivals();
+        while(!wake.empty()){
+            int c = wake.back(); wake.pop_back();
+            if(cores[c].running >= 0) continue;
+            int idx = pick_next(c);
+            if(idx >= 0) start_slice(c, idx);
+        }
+    }
+    void start_slice(int c, int idx){
+        if(procs.start_time[idx]<0) procs.start_time[idx] = current_time;
+        double io_weight = procs.io_weight[idx];
+        double remaining = procs.remaining[idx];
+        double slice = queues[c].slice(idx, quantum);
+        double speed = io_blocking ? 1.0 : 1.0 - io_weight; // work done per ms on the CPU
+        double run = min(slice, remaining / max(speed, 1e-9)); // ensure some progress
+        if(run <= 0) run = slice;
+        set_running(c, idx);
+        Core &k = cores[c];
+        k.start = current_time; k.slice = slice; k.run = run; k.weight = max(0.0, speed);
+        running_weight += k.weight; running_wstart += k.weight * k.start; busy_cores++;
+        bool finishes = max(0.0, remaining - run * speed) <= 1e-9; // same test as end_slice
+        events.push(current_time + run, {finishes ? EV_COMPLETION : EV_QUANTUM_EXPIRY, c});
+    }
+    // the slice on core c ends at current_time
+    void end_slice(int c){
+        Core &k = cores[c];
+        int idx = k.running;
+        double run = k.run, slice = k.slice;
+        // CPU effective work is reduced by io_weight, unless I/O is simulated as blocking
+        double io_weight = procs.io_weight[idx];
+        double cpu_run = io_blocking ? run : run * (1.0 - io_weight);
         // guard: cpu_run could be zero for io_weight ~1. Still we must advance time by 'run'
-        pr.remaining -= cpu_run;
-        if(pr.remaining < 0) pr.remaining = 0;
-        pr.cpu_consumed += cpu_run;
-        current_time += run;
-        double util = instant_cpu_util();
+        double remaining = procs.remaining[idx] - cpu_run;
+        if(remaining < 0) remaining = 0;
+        procs.remaining[idx] = remaining;
+        top_consumers.update(idx, procs.cpu_consumed[idx], procs.cpu_consumed[idx] + cpu_run);
+        procs.cpu_consumed[idx] += cpu_run;
+        classes.update(procs, idx);
+        bool finished = remaining <= 1e-9;
+        if(finished) procs.finish_time[idx] = current_time;
+        k.busy_done += k.weight * run; busy_done_total += k.weight * run;
+        running_weight -= k.weight; running_wstart -= k.weight * k.start; busy_cores--;
+        if(busy_cores == 0) running_weight = running_wstart = 0; // drop accumulated rounding
+        set_running(c, -1);
+        // arrivals during the quantum queue ahead of a preempted job and count towards this sample
+        admit_arrivals();
+        if(finished){
+            retire(idx); queues[c].finish(idx);
+            if(stream) release_slot(idx);
+        } else if(io_blocking && io_weight > 0){
+            // off the CPU until the I/O completes, then queued afresh like a wakeup
+            events.push(current_time + run * io_weight / max(1.0 - io_weight, 1e-9), {EV_IO_COMPLETION, idx});
+        } else {
+            queues[c].requeue(procs, idx, run, run >= slice - 1e-9);
+            set_queued(c, +1);
+        }
+        wake.push_back(c);
+    }
+
+    bool all_done(){ return completed == seen && !arrivals_pending(); }
+
+    void schedule_arrival(){
+        if(arrival_scheduled || !arrivals_pending()) return;
+        events.push(next_arrival_time(), {EV_ARRIVAL, -1});
+        arrival_scheduled = true;
+    }
+
+    // handles the next event, then starts work on any core left idle;
+    // false when no event is left
+    bool step(){
+        AIPO_PROF_SCOPE("step");
+        SimEvent e;
+        double t;
+        if(!events.pop(t, e)) return false;
+        current_time = t;
+        events_handled++;
+        switch(e.kind){
+        case EV_ARRIVAL: {
+            bool idle = busy_cores == 0;
+            arrival_scheduled = false;
+            admit_arrivals();
+            schedule_arrival();
+            if(idle){ // an idle gap ends: record it
+                phases.lap(PH_SCHED);
+                double mem = total_mem();
+                record_sample(0, mem);
+                max_observed_mem = max(max_observed_mem, mem);
+                phases.lap(PH_SAMPLE);
+            }
+            break;
+        }
+        case EV_QUANTUM_EXPIRY:
+        case EV_COMPLETION: {
+            end_slice(e.id);
+            phases.lap(PH_SCHED);
+            double util = instant_cpu_util();
+            double mem = total_mem();
+            record_sample(util, mem);
+            max_observed_mem = max(max_observed_mem, mem);
+            phases.lap(PH_SAMPLE);
+            break;
+        }
+        case EV_IO_COMPLETION:
+            enqueue(e.id);
+            break;
+        case EV_ANALYSIS:
+            phases.lap(PH_SCHED);
+            analyze_and_report(t);
+            events.push(t + analysis_interval, {EV_ANALYSIS, -1}, 1);
+            phases.lap(PH_ANALYSIS);
+            break;
+        }
+        dispatch();
+        phases.lap(PH_SCHED);
+        return true;
+    }
+
+    // appends one sample at current_time to both series and their incremental stats
+    void record_sample(double util, double mem){
         cpu_util_ts.push_back({current_time, util});
-        mem_usage_ts.push_back({current_time, total_mem()});
-        max_observed_mem = max(max_observed_mem, total_mem());
-        if(pr.remaining <= 1e-9) pr.finish_time = current_time;
+        mem_usage_ts.push_back({current_time, mem});
+        util_windows.add({current_time, util});
+        mem_regression.add({current_time, mem});
+        forecasters.add(current_time, mem);
+        sample_time = current_time; sample_busy = busy_total(current_time);
     }
+    double busy_total(double t) const { return busy_done_total + running_weight * t - running_wstart; }
 
+    // O(1): both read the running aggregates; callers must admit_arrivals() first
     double total_mem(){
-        double s=0; for(auto &p: procs) if(p.arrival<=current_time && p.remaining>1e-9) s+=p.mem_kb; return s;
+        check_aggregates();
+        return live_mem;
     }
+    // One CPU: the original measure, busy share summed over every process
+    // seen, so single-core reports stay comparable with earlier runs. N cores:
+    // busy share of all cores since the previous sample (time-weighted, so
+    // several slices ending at the same instant do not read as idle).
     double instant_cpu_util(){
-        double busy=0;
-        for(auto &p: procs) if(p.arrival<=current_time && p.remaining>1e-9) busy += max(0.0, 1.0 - p.io_weight);
-        double max_possible = max(1.0, (double)procs.size());
-        double util = min(100.0, (busy/max_possible)*100.0);
+        check_aggregates();
+        if(ncores > 1){
+            double dt = current_time - sample_time;
+            if(dt <= 0) return cpu_util_ts.empty() ? 0.0 : cpu_util_ts.back().value;
+            return min(100.0, 100.0 * (busy_total(current_time) - sample_busy) / (dt * ncores));
+        }
+        double max_possible = max(1.0, (double)seen);
+        double util = min(100.0, (live_busy/max_possible)*100.0);
         return util;
     }
 
+    void check_aggregates(){
+#ifdef AIPO_CHECK_AGGREGATES
+        double mem=0, busy=0; int cnt=0;
+        for(size_t i=0;i<procs.size();++i) if(procs.arrival[i]<=current_time && procs.remaining[i]>1e-9){
+            mem += procs.mem_kb[i]; busy += max(0.0, 1.0 - procs.io_weight[i]); cnt++;
+        }
+        if(cnt != live_count || fabs(mem - live_mem) > 1e-6 * max(1.0, mem) || fabs(busy - live_busy) > 1e-6 * max(1.0, busy)){
+            cerr << "aggregate drift at t=" << current_time << ": live_count " << live_count << " vs " << cnt
+                 << ", live_mem " << live_mem << " vs " << mem << ", live_busy " << live_busy << " vs " << busy << "\n";
+            abort();
+        }
+#endif
+    }
+
+    // -DAIPO_CHECK_AGGREGATES: the class index against a fresh rebuild
+    void check_classes(){
+#ifdef AIPO_CHECK_AGGREGATES
+        ProcessClasses fresh; fresh.rules = classes.rules;
+        fresh.build(procs);
+        if(fresh.hot != classes.hot || fresh.classified != classes.classified || !equal(fresh.count, fresh.count+3, classes.count)){
+            cerr << "class index drift at t=" << current_time << ": " << classes.hot.size() << " hotspots vs "
+                 << fresh.hot.size() << ", " << classes.classified.size() << " classified vs " << fresh.classified.size() << "\n";
+            abort();
+        }
+#endif
+    }
+
     void run_and_analyze(){
-        open_csv();
-        double analysis_interval = 100.0; double next_analysis = analysis_interval;
-        const double EPS = 1e-6;
-        // initial record
-        cpu_util_ts.push_back({current_time, 0.0});
-        mem_usage_ts.push_back({current_time, total_mem()});
-        while(!all_done()){
-            double prev_time = current_time;
-            step();
-            if(current_time <= prev_time + EPS){
-                // ensure progress: jump to next arrival or add tiny epsilon
-                double tnext = 1e18;
-                for(auto &p: procs) if(p.arrival>current_time) tnext=min(tnext,p.arrival);
-                if(tnext==1e18) break;
-                current_time = max(current_time + 1.0, tnext); // advance by 1 ms
-            }
-            // robust analysis loop (handles multiple missed intervals)
-            while(current_time >= next_analysis){
-                analyze_and_report(next_analysis);
-                next_analysis += analysis_interval;
-            }
+        begin_run();
+        while(!all_done() && step()){}
+        end_run();
+    }
+    // opens the outputs and queues the first events; step() from here on
+    void begin_run(){
+        phases.start();
+        events_handled = 0;
+        if(!csv_path.empty()) open_csv(csv_path); // empty: no CSV (sweep runs)
+        if(ncores > 1 && !cores_csv_path.empty()){
+            if(cores_csv.open(cores_csv_path)) cores_csv.write("time_ms,core,util_pct,queued,running_pid\n");
         }
+        if(!json_path.empty() && !json.open(json_path)) cerr << "Cannot create " << json_path << "\n";
+        last_tick = 0;
+        phases.lap(PH_IO);
+        // initial record
+        admit_arrivals();
+        record_sample(0.0, total_mem());
+        schedule_arrival();
+        events.push(analysis_interval, {EV_ANALYSIS, -1}, 1);
+        dispatch();
+    }
+    void end_run(){
         // final analysis (at end time)
+        phases.lap(PH_SCHED);
         analyze_and_report(current_time);
-        close_csv();
+        phases.lap(PH_ANALYSIS);
+        if(json.is_open()) json_summary();
+        close_csv(); // waits for the writer threads to drain
+        phases.lap(PH_IO);
+    }
+
+    // whole-run history from the archive tier: one row per bucket
+    void write_history_csv(const string& path){
+        ofstream out(path);
+        out << "time_ms,cpu_min,cpu_max,cpu_mean,mem_min_kb,mem_max_kb,mem_mean_kb\n" << fixed << setprecision(3);
+        for(size_t i=0;i<cpu_util_ts.archive.size() && i<mem_usage_ts.archive.size();++i){
+            const SeriesBucket &c = cpu_util_ts.archive[i], &m = mem_usage_ts.archive[i];
+            out << c.start << "," << c.min << "," << c.max << "," << c.mean() << ","
+                << m.min << "," << m.max << "," << m.mean() << "\n";
+        }
+    }
+
+    RunSummary summary() const {
+        RunSummary r;
+        r.processes = seen; r.completed = completed; r.analysis_ticks = analysis_ticks;
+        r.end_time = current_time; r.peak_mem = max_observed_mem;
+        r.avg_turnaround = completed ? sum_turnaround / completed : 0.0; // zero-burst jobs count as 0
+        r.mean_avg_util = analysis_ticks ? sum_avg_util / analysis_ticks : 0.0;
+        r.max_forecast = max_forecast;
+        r.forecast_model = forecast_model;
+        r.forecasts_checked = forecasts_checked;
+        for(int m=0;m<FC_COUNT;++m) r.model_mae[m] = forecasts_checked ? sum_forecast_err[m] / forecasts_checked : 0.0;
+        r.forecast_mae = r.model_mae[forecast_model];
+        r.hotspot_ticks = hotspot_ticks;
+        r.cores = ncores; r.migrations = migrations;
+        r.cpu_busy_pct = current_time > 0 ? 100.0 * busy_total(current_time) / (current_time * ncores) : 0.0;
+        r.events = events_handled;
+        copy(phases.ms, phases.ms + PH_COUNT, r.phase_ms);
+        return r;
+    }
+
+    // busy share of each core since the previous tick into core_util; O(cores), once per tick
+    void update_core_util(double at_time){
+        double span = max(at_time - last_tick, 1e-9);
+        core_util.resize(ncores);
+        for(int c=0;c<ncores;++c){
+            Core &k = cores[c];
+            double busy = k.busy_ms(current_time);
+            core_util[c] = min(100.0, max(0.0, 100.0 * (busy - k.busy_at_tick) / span));
+            k.busy_at_tick = busy;
+            if(cores_csv.is_open()){
+                cores_csv.add((long long)round(at_time)); cores_csv.add(c); cores_csv.add((int)round(core_util[c]));
+                cores_csv.add(k.queued); cores_csv.add(k.running >= 0 ? procs.pid[k.running] : -1);
+                cores_csv.end_row();
+            }
+        }
+        last_tick = at_time;
     }
 
+    // {"type":"tick",...}: the CSV columns plus the top consumers, hotspot
+    // pids, class counts and per-core util
+    void json_tick(double at_time, double avg_util, double mem, double slope, const double* forecasts){
+        json.write("{\"type\":\"tick\",\"time_ms\":"); json_num(at_time);
+        json.write(",\"avg_cpu_util\":"); json_num(avg_util);
+        json.write(",\"mem_kb\":"); json_num(mem);
+        json.write(",\"slope_kb_per_ms\":"); json_num(slope);
+        json.write(",\"forecast_kb\":"); json_num(forecasts[forecast_model]);
+        json.write(",\"forecasts_kb\":{");
+        for(int m=0;m<FC_COUNT;++m){
+            json.write(m ? ",\"" : "\""); json.write(forecast_model_name(m)); json.write("\":"); json_num(forecasts[m]);
+        }
+        json.write("},\"top\":[");
+        for(size_t k=0;k<top_list.size();++k){
+            int i = top_list[k].second;
+            json.write(k ? ",{\"pid\":" : "{\"pid\":"); json.put(procs.pid[i]);
+            json.write(",\"cpu_ms\":"); json_num(procs.cpu_consumed[i]);
+            json.write(",\"mem_kb\":"); json_num(procs.mem_kb[i]);
+            json.write(",\"io_weight\":"); json_num(procs.io_weight[i]);
+            json.write("}");
+        }
+        json.write("],\"hotspots\":[");
+        bool first = true;
+        for(int i: classes.hot){ if(!first) json.write(","); json.put(procs.pid[i]); first = false; }
+        json.write("],\"cpu_bound\":"); json.put(classes.count[CLS_CPU]);
+        json.write(",\"io_bound\":"); json.put(classes.count[CLS_IO]);
+        json.write(",\"mixed\":"); json.put(classes.count[CLS_MIXED]);
+        if(ncores > 1){
+            json.write(",\"core_util\":[");
+            for(int c=0;c<ncores;++c){ if(c) json.write(","); json_num(core_util[c]); }
+            json.write("]");
+        }
+        json.write("}\n");
+    }
+    void json_summary(){
+        RunSummary r = summary();
+        json.write("{\"type\":\"summary\",\"processes\":"); json.put(r.processes);
+        json.write(",\"completed\":"); json.put(r.completed);
+        json.write(",\"end_time_ms\":"); json_num(r.end_time);
+        json.write(",\"avg_turnaround_ms\":"); json_num(r.avg_turnaround);
+        json.write(",\"peak_mem_kb\":"); json_num(r.peak_mem);
+        json.write(",\"analysis_ticks\":"); json.put(r.analysis_ticks);
+        json.write(",\"forecast_model\":\""); json.write(forecast_model_name(r.forecast_model));
+        json.write("\",\"forecast_mae_kb\":"); json_num(r.forecast_mae);
+        json.write(",\"model_mae_kb\":{");
+        for(int m=0;m<FC_COUNT;++m){
+            json.write(m ? ",\"" : "\""); json.write(forecast_model_name(m)); json.write("\":"); json_num(r.model_mae[m]);
+        }
+        json.write("},\"forecasts_checked\":"); json.put(r.forecasts_checked);
+        json.write(",\"cores\":"); json.put(r.cores);
+        json.write(",\"cpu_busy_pct\":"); json_num(r.cpu_busy_pct);
+        json.write(",\"migrations\":"); json.put(r.migrations);
+        json.write("}\n");
+    }
+    void json_num(double v){ if(isfinite(v)) json.put(v); else json.write("null"); } // JSON has no inf/nan
+
+    // Per-tick analysis. Text goes to *out as verbosity allows: brief keeps
+    // the O(1)-sized lines, full adds the O(processes) ones (hotspot list,
+    // classification, Gantt). Quiet skips the text, and the work done only
+    // for it, entirely; CSV and JSON lines rows are written at every level.
     void analyze_and_report(double at_time){
-        cout << "\n--- Analysis at t=" << (int)round(at_time) << " ms ---\n";
-        // top CPU consumers
-        vector<pair<double,int>> cpu_consumers;
-        for(int i=0;i<procs.size();++i) cpu_consumers.push_back({procs[i].cpu_consumed, i});
-        sort(cpu_consumers.rbegin(), cpu_consumers.rend());
-        cout << "Top CPU consumers:\n";
-        for(int k=0;k<min(3,(int)cpu_consumers.size());++k){
-            auto &pr = procs[cpu_consumers[k].second];
-            cout << " P"<<pr.pid<<" cpu_ms="<< (int)round(pr.cpu_consumed) <<" mem="<< (int)pr.mem_kb <<" io="<<pr.io_weight<<"\n";
-        }
-        double avg_util = Analyzer::moving_avg(cpu_util_ts, 200.0);
-        cout << "Avg CPU util (recent 200ms) = "<< fixed << setprecision(2) << avg_util <<"%\n";
+        AIPO_PROF_SCOPE("analyze_and_report");
+        analysis_ticks++;
+        ostream& os = *out;
+        bool brief = verbosity >= VERB_BRIEF, full = verbosity >= VERB_FULL;
+        if(ncores > 1) update_core_util(at_time);
+        if(brief) os << "\n--- Analysis at t=" << (int)round(at_time) << " ms ---\n";
+        // top CPU consumers, O(top_k) from the index
+        top_consumers.top(top_k, procs, top_list);
+        if(brief){
+            os << "Top CPU consumers:\n";
+            for(auto &e: top_list){
+                int i = e.second;
+                os << " P"<<procs.pid[i]<<" cpu_ms="<< (int)round(procs.cpu_consumed[i]) <<" mem="<< (int)procs.mem_kb[i] <<" io="<<procs.io_weight[i]<<"\n";
+            }
+        }
+        double avg_util = util_windows.mean(util_avg_window); // same as Analyzer::moving_avg(cpu_util_ts, util_window_ms)
+        if(brief) os << "Avg CPU util (recent " << (long long)round(util_window_ms) << "ms) = "<< fixed << setprecision(2) << avg_util <<"%\n";
 
         // regression (slope estimate) with offset and stability
-        auto reg = Analyzer::linear_regression_offset(mem_usage_ts, 10);
+        auto reg = mem_regression.result(); // Analyzer::linear_regression_offset(mem_usage_ts, regression_points), incrementally
         double slope = reg.first; // kb per ms approx
         double last_mem = mem_usage_ts.empty()?0.0:mem_usage_ts.back().value;
-        double forecast = last_mem + slope * 500.0; // 500ms ahead
+        // every model forecasts at each tick, so each has an error to report
+        OpenForecast f{at_time + forecast_horizon, {}};
+        f.value[FC_LINEAR] = last_mem + slope * forecast_horizon;
+        forecasters.advance(at_time);
+        for(int m=FC_EWMA;m<FC_COUNT;++m) f.value[m] = forecasters.forecast(m, f.time);
         // clamp forecast
         double cap = max( (double)0.0, 2.0 * max_observed_mem );
         if(cap < 1.0) cap = max( (double)100.0, last_mem * 2.0 );
-        if(forecast < 0.0) forecast = 0.0;
-        if(forecast > cap) forecast = cap;
-
-        cout << "Memory slope = " << setprecision(4) << slope << " kb/ms. Forecast in 500ms = " << (long long)round(forecast) << " kb\n";
-        if(forecast > 1024.0 * 1024.0) cout << "Warning: projected memory > 1GB, suggest reduce working set or enable swap.\n";
-
-        int hotspots = 0;
-        for(auto &p: procs){
-            if(p.cpu_consumed > 100 && p.remaining > 50){
-                cout<<"Hotspot detected: P"<<p.pid<<" (cpu_ms="<<(int)round(p.cpu_consumed)<<", rem="<<(int)round(p.remaining)<<"ms)\n";
-                cout<<"Suggestion: consider lowering priority or parallelizing workload.\n";
-                hotspots++;
+        for(double &v: f.value) v = min(max(v, 0.0), cap);
+        double forecast = f.value[forecast_model];
+
+        if(brief){
+            os << "Memory slope = " << setprecision(4) << slope << " kb/ms. Forecast";
+            if(forecast_model != FC_LINEAR) os << " (" << forecast_model_name(forecast_model) << ")";
+            os << " in " << (long long)round(forecast_horizon) << "ms = " << (long long)round(forecast) << " kb\n";
+        }
+        // score forecasts that have come due against the memory seen now
+        while(!open_forecasts.empty() && open_forecasts.front().time <= at_time){
+            for(int m=0;m<FC_COUNT;++m) sum_forecast_err[m] += fabs(open_forecasts.front().value[m] - last_mem);
+            forecasts_checked++;
+            open_forecasts.pop_front();
+        }
+        open_forecasts.push_back(f);
+        sum_avg_util += avg_util;
+        max_forecast = max(max_forecast, forecast);
+        if(brief && forecast > 1024.0 * 1024.0) os << "Warning: projected memory > 1GB, suggest reduce working set or enable swap.\n";
+
+        check_classes();
+        const double *cpu = procs.cpu_consumed.data(), *rem = procs.remaining.data();
+        int hotspots = (int)classes.hot.size();
+        hotspot_ticks += hotspots > 0;
+        if(full){
+            for(int i: classes.hot){
+                os<<"Hotspot detected: P"<<procs.pid[i]<<" (cpu_ms="<<(int)round(cpu[i])<<", rem="<<(int)round(rem[i])<<"ms)\n";
+                os<<"Suggestion: consider lowering priority or parallelizing workload.\n";
             }
+        } else if(brief && hotspots) os << "Hotspots: " << hotspots << "\n";
+        if(json.is_open()){
+            phases.lap(PH_ANALYSIS);
+            json_tick(at_time, avg_util, last_mem, slope, f.value);
+            phases.lap(PH_IO);
         }
         // classification
-        for(auto &p: procs){
-            if(p.cpu_consumed > 0){
-                double cpu_frac = p.cpu_consumed / max(1.0, (double)p.burst);
-                if(cpu_frac>0.7) cout<<"P"<<p.pid<<" classified: CPU-bound\n";
-                else if(p.io_weight>0.6) cout<<"P"<<p.pid<<" classified: IO-bound\n";
-                else cout<<"P"<<p.pid<<" classified: Mixed\n";
-            }
+        if(full){
+            for(int i: classes.classified) os<<"P"<<procs.pid[i]<<" classified: "<<classes.name(classes.cls[i])<<"\n";
+            os << "Gantt snapshot (pid:remaining_ms): ";
+            for(size_t i=0;i<procs.size();++i) if(procs.arrival[i]<=current_time && rem[i]>1e-9) os<<"[P"<<procs.pid[i]<<":"<<(int)round(rem[i])<<"ms] ";
+            os << "\n";
+        }
+        if(ncores > 1 && brief){
+            os << "Per-core util since last tick:";
+            for(int c=0;c<ncores;++c) os << " c" << c << "=" << (int)round(core_util[c]) << "%";
+            os << " (migrations so far: " << migrations << ")\n";
         }
-        cout << "Gantt snapshot (pid:remaining_ms): ";
-        for(auto &p: procs) if(p.arrival<=current_time && p.remaining>1e-9) cout<<"[P"<<p.pid<<":"<<(int)round(p.remaining)<<"ms] ";
-        cout << "\n";
 
-        // write CSV row: time,avg_util,mem,slope,forecast,top3 pids+cpu,hotspots
-        int t1_pid=-1; long long t1_cpu=0, t2_cpu=0, t3_cpu=0; int t2_pid=-1, t3_pid=-1;
-        if(cpu_consumers.size()>0){ t1_pid = procs[cpu_consumers[0].second].pid; t1_cpu = (long long)round(cpu_consumers[0].first); }
-        if(cpu_consumers.size()>1){ t2_pid = procs[cpu_consumers[1].second].pid; t2_cpu = (long long)round(cpu_consumers[1].first); }
-        if(cpu_consumers.size()>2){ t3_pid = procs[cpu_consumers[2].second].pid; t3_cpu = (long long)round(cpu_consumers[2].first); }
-        if(csv.is_open()){
-            csv << (long long)round(at_time) << "," << fixed << setprecision(3) << avg_util << "," << (long long)round(last_mem)
-                << "," << slope << "," << (long long)round(forecast) << ","
-                << t1_pid << "," << t1_cpu << "," << t2_pid << "," << t2_cpu << "," << t3_pid << "," << t3_cpu << "," << hotspots << "\n";
+        // write CSV row: time,avg_util,mem,slope,forecast,top_k pids+cpu (-1,0 when fewer),hotspots
+        if(csv.is_open()){ // formatted here, written by the CSV writer thread
+            phases.lap(PH_ANALYSIS);
+            csv.add((long long)round(at_time)); csv.add(avg_util, 3); csv.add((long long)round(last_mem));
+            csv.add(slope, 3); csv.add((long long)round(forecast));
+            for(size_t k=0;k<top_k;++k){
+                bool has = k < top_list.size();
+                csv.add(has ? procs.pid[top_list[k].second] : -1); csv.add(has ? (long long)round(top_list[k].first) : 0LL);
+            }
+            csv.add(hotspots);
+            csv.end_row();
+            phases.lap(PH_IO);
         }
     }
 };
@@ -247,20 +877,517 @@ vector<tuple<double,double,double,double>> sample_jobs(){
     };
 }
 
+// (arrival, burst, mem_kb, io_weight) tuples -> process table with pids 1..n
+ProcessTable table_from_jobs(const vector<tuple<double,double,double,double>>& jobs){
+    ProcessTable table; int id=1;
+    table.reserve(jobs.size());
+    for(auto &t: jobs) table.push_back(Process(id++, get<0>(t), get<1>(t), get<2>(t), get<3>(t)));
+    return table;
+}
+
+// stream != nullptr selects bounded-memory ingestion; table is ignored then
+template<class Policy>
+RunSummary simulate(ProcessTable& table, TraceStream* stream, const SimOptions& opt){
+    Simulator<Policy> sim;
+    sim.configure(opt);
+    if(stream) sim.load_stream(*stream); else sim.load(move(table));
+    sim.run_and_analyze();
+    if(opt.archive_bucket_ms > 0) sim.write_history_csv(opt.history_path);
+    return sim.summary();
+}
+typedef RunSummary (*SimulateFn)(ProcessTable&, TraceStream*, const SimOptions&);
+
+#ifndef AIPO_NO_MAIN // defined by programs that include this file for the simulator alone (bench/)
+static SimulateFn policy_runner(const string& policy){
+    if(policy==FcfsPolicy::name) return simulate<FcfsPolicy>;
+    if(policy==RoundRobinPolicy::name) return simulate<RoundRobinPolicy>;
+    if(policy==SrtfPolicy::name) return simulate<SrtfPolicy>;
+    if(policy==PriorityPolicy::name) return simulate<PriorityPolicy>;
+    if(policy==MlfqPolicy::name) return simulate<MlfqPolicy>;
+    if(policy==CfsPolicy::name) return simulate<CfsPolicy>;
+    if(policy==EdfPolicy::name) return simulate<EdfPolicy>;
+    return nullptr;
+}
+
+// Batch mode: every trace runs in its own Simulator on a worker thread and
+// writes analysis_<name>.csv / output_<name>.txt into out_dir (the same
+// naming as the checked-in sample results); batch_summary.csv collects one
+// row per trace in input order.
+static int run_batch(const vector<string>& inputs, SimulateFn run, SimOptions base, bool streaming,
+                     unsigned threads, const string& out_dir){
+    namespace fs = std::filesystem;
+    vector<string> traces;
+    for(auto &in: inputs){
+        if(fs::is_directory(in)){
+            vector<string> found;
+            for(auto &e: fs::directory_iterator(in)){
+                string ext = e.path().extension().string();
+                if(e.is_regular_file() && (ext==".txt" || ext==".bin")) found.push_back(e.path().string());
+            }
+            sort(found.begin(), found.end());
+            traces.insert(traces.end(), found.begin(), found.end());
+        } else traces.push_back(in);
+    }
+    if(traces.empty()){ cerr<<"No traces found\n"; return 1; }
+    fs::create_directories(out_dir);
+
+    struct Result { RunSummary sum; double wall_ms = 0; string error; };
+    vector<Result> results(traces.size());
+    mutex log_mu;
+    parallel_for(traces.size(), threads, [&](size_t k){
+        auto t0 = chrono::steady_clock::now();
+        string name = fs::path(traces[k]).stem().string();
+        Result &res = results[k];
+        try {
+            ofstream text; // quiet runs write no text report
+            SimOptions opt = base;
+            if(base.verbosity > VERB_QUIET){
+                text.open((fs::path(out_dir) / ("output_" + name + ".txt")).string());
+                opt.report = &text;
+            }
+            if(!base.json_path.empty()) opt.json_path = (fs::path(out_dir) / ("report_" + name + ".jsonl")).string();
+            opt.csv_path = (fs::path(out_dir) / ("analysis_" + name + ".csv")).string();
+            opt.history_path = (fs::path(out_dir) / ("analysis_history_" + name + ".csv")).string();
+            opt.cores_csv_path = (fs::path(out_dir) / ("analysis_cores_" + name + ".csv")).string();
+            ProcessTable table;
+            TraceStream stream;
+            if(streaming){ if(!stream.open(traces[k])) throw runtime_error("Cannot open " + traces[k]); }
+            else load_trace(traces[k], table);
+            res.sum = run(table, streaming ? &stream : nullptr, opt);
+        } catch(const exception& e){
+            res.error = e.what();
+        }
+        res.wall_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        lock_guard<mutex> lk(log_mu);
+        cout << (res.error.empty() ? "done  " : "FAILED ") << traces[k]
+             << (res.error.empty() ? "" : ": " + res.error) << "\n" << flush;
+    });
+
+    ofstream summary((fs::path(out_dir) / "batch_summary.csv").string());
+    summary << "trace,status,processes,completed,end_time_ms,avg_turnaround_ms,peak_mem_kb,analysis_ticks,wall_ms\n"
+            << fixed << setprecision(3);
+    int failed = 0;
+    for(size_t k=0;k<traces.size();++k){
+        const Result &r = results[k];
+        failed += !r.error.empty();
+        summary << traces[k] << "," << (r.error.empty() ? "ok" : "error") << "," << r.sum.processes << ","
+                << r.sum.completed << "," << r.sum.end_time << "," << r.sum.avg_turnaround << ","
+                << r.sum.peak_mem << "," << r.sum.analysis_ticks << "," << r.wall_ms << "\n";
+    }
+    cout << "\nBatch finished: " << traces.size() - failed << " ok, " << failed << " failed. Summary saved to "
+         << (fs::path(out_dir) / "batch_summary.csv").string() << "\n";
+    return failed ? 1 : 0;
+}
+
+// One value per grid point of a swept parameter.
+struct SweepGrid {
+    vector<string> policies;
+    vector<double> quantum, interval, window, horizon;
+    vector<size_t> reg_points;
+    vector<int> cores;
+};
+
+// "a,b,c" or "lo:hi:step" (inclusive) -> values; throws on anything else
+static vector<double> parse_values(const string& spec){
+    vector<double> vals;
+    auto num = [&](const string& t){
+        double v; auto r = from_chars(t.data(), t.data() + t.size(), v);
+        if(t.empty() || r.ec != errc() || r.ptr != t.data() + t.size()) throw runtime_error("bad value '" + t + "' in " + spec);
+        return v;
+    };
+    size_t c1 = spec.find(':');
+    if(c1 != string::npos){
+        size_t c2 = spec.find(':', c1+1);
+        if(c2 == string::npos) throw runtime_error("range needs lo:hi:step, got " + spec);
+        double lo = num(spec.substr(0, c1)), hi = num(spec.substr(c1+1, c2-c1-1)), step = num(spec.substr(c2+1));
+        if(!(step > 0) || hi < lo) throw runtime_error("empty range " + spec);
+        // counted rather than accumulated so 0.1 steps do not drift past hi
+        for(long long k=0; lo + k*step <= hi + 1e-9*step; ++k) vals.push_back(lo + k*step);
+        return vals;
+    }
+    stringstream ss(spec); string tok;
+    while(getline(ss, tok, ',')) vals.push_back(num(tok));
+    if(vals.empty()) throw runtime_error("no values in " + spec);
+    return vals;
+}
+
+// Sweep mode: the trace is parsed once into a table shared read-only by all
+// workers, every grid point (policy x cores x quantum x interval x window x
+// reg_points x horizon) simulates a private copy of it with report text and
+// CSV switched off, and the results land in one table, one row per point in
+// grid order.
+static int run_sweep(const string& trace, const SweepGrid& grid, SimOptions base, unsigned threads,
+                     const string& out_path){
+    ProcessTable loaded;
+    if(!trace.empty()) load_trace(trace, loaded);
+    else loaded = table_from_jobs(sample_jobs());
+    const ProcessTable& shared = loaded;
+
+    struct Point { string policy; SimOptions opt; };
+    vector<Point> points;
+    for(auto &pol: grid.policies) for(int nc: grid.cores) for(double q: grid.quantum) for(double iv: grid.interval)
+    for(double w: grid.window) for(size_t rp: grid.reg_points) for(double h: grid.horizon){
+        Point pt{pol, base};
+        pt.opt.cores = nc; pt.opt.quantum = q; pt.opt.analysis_interval = iv; pt.opt.util_window_ms = w;
+        pt.opt.regression_points = rp; pt.opt.forecast_horizon_ms = h;
+        pt.opt.csv_path = pt.opt.cores_csv_path = ""; pt.opt.archive_bucket_ms = 0;
+        string bad = invalid_option(pt.opt);
+        if(!bad.empty()) throw runtime_error(bad);
+        points.push_back(pt);
+    }
+    cout << "Sweeping " << points.size() << " parameter combinations over " << shared.size()
+         << " jobs on " << min<size_t>(threads, points.size()) << " threads\n" << flush;
+
+    struct Result { RunSummary sum; double wall_ms = 0; string error; };
+    vector<Result> results(points.size());
+    parallel_for(points.size(), threads, [&](size_t k){
+        auto t0 = chrono::steady_clock::now();
+        Result &res = results[k];
+        try {
+            SimOptions opt = points[k].opt;
+            opt.verbosity = VERB_QUIET;
+            opt.json_path = "";
+            ProcessTable table = shared; // the run mutates remaining/cpu_consumed
+            res.sum = policy_runner(points[k].policy)(table, nullptr, opt);
+        } catch(const exception& e){
+            res.error = e.what();
+        }
+        res.wall_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    });
+
+    ofstream out(out_path);
+    if(!out) throw runtime_error("Cannot create " + out_path);
+    out << "policy,cores,quantum_ms,analysis_interval_ms,util_window_ms,regression_points,forecast_horizon_ms,status,"
+           "end_time_ms,avg_turnaround_ms,peak_mem_kb,analysis_ticks,mean_avg_cpu_util,max_forecast_kb,forecast_mae_kb,";
+    for(int m=0;m<FC_COUNT;++m) out << "mae_" << forecast_model_name(m) << "_kb,";
+    out << "hotspot_ticks,cpu_busy_pct,migrations,wall_ms\n" << fixed << setprecision(3);
+    int failed = 0;
+    for(size_t k=0;k<points.size();++k){
+        const SimOptions &o = points[k].opt;
+        const Result &r = results[k];
+        failed += !r.error.empty();
+        out << points[k].policy << "," << o.cores << "," << o.quantum << "," << o.analysis_interval << "," << o.util_window_ms << ","
+            << o.regression_points << "," << o.forecast_horizon_ms << "," << (r.error.empty() ? "ok" : "error") << ","
+            << r.sum.end_time << "," << r.sum.avg_turnaround << "," << r.sum.peak_mem << "," << r.sum.analysis_ticks << ","
+            << r.sum.mean_avg_util << "," << r.sum.max_forecast << "," << r.sum.forecast_mae << ",";
+        for(int m=0;m<FC_COUNT;++m) out << r.sum.model_mae[m] << ",";
+        out << r.sum.hotspot_ticks << "," << r.sum.cpu_busy_pct << "," << r.sum.migrations << "," << r.wall_ms << "\n";
+        if(!r.error.empty()) cerr << "run " << k << " failed: " << r.error << "\n";
+    }
+    cout << "Sweep finished: " << points.size() - failed << " ok, " << failed << " failed. Results saved to "
+         << out_path << "\n";
+    return failed ? 1 : 0;
+}
+
+// peak resident set of this process so far, in kb (-1 if unknown)
+static long long peak_rss_kb(){
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof pmc)) return (long long)(pmc.PeakWorkingSetSize / 1024);
+    return -1;
+#else
+    struct rusage ru;
+    if(getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024; // bytes there
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+}
+
+// End-to-end benchmark: the whole pipeline (trace load, run_and_analyze,
+// CSV output) `repeat` times on the trace, or on a generated workload when
+// there is none. Reports the fastest run: simulated events per second, wall
+// time per simulated second, peak RSS and the time per phase. --out appends
+// one CSV row per invocation, to compare builds over time.
+static int run_bench_mode(const string& trace, const string& policy, SimulateFn run, SimOptions opt, bool streaming,
+                          const WorkloadSpec& spec, int repeat, const string& out_path){
+    opt.time_phases = true;
+    ProcessTable generated;
+    if(trace.empty()){
+        WorkloadGen gen(spec);
+        TraceRow r; int id = 1;
+        generated.reserve(spec.count);
+        while(gen.next(r)) generated.push_back(Process(id++, r.arrival, r.burst, r.mem_kb, r.io_weight));
+    }
+    RunSummary best; double best_wall = 1e300, best_load = 0;
+    for(int k=0;k<repeat;++k){
+        ProcessTable table;
+        TraceStream stream;
+        if(trace.empty()) table = generated; // copied untimed: generation is not part of the pipeline
+        auto t0 = chrono::steady_clock::now();
+        if(streaming){ if(!stream.open(trace)) throw runtime_error("Cannot open " + trace); }
+        else if(!trace.empty()) load_trace(trace, table);
+        double load_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        RunSummary sum = run(table, streaming ? &stream : nullptr, opt);
+        double wall = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "run " << k+1 << ": " << fixed << setprecision(1) << wall << " ms, "
+             << setprecision(0) << sum.events / max(wall / 1000, 1e-9) << " events/s\n" << flush;
+        if(wall < best_wall){ best = sum; best_wall = wall; best_load = load_ms; }
+    }
+    double sim_s = best.end_time / 1000, events_per_s = best.events / max(best_wall / 1000, 1e-9);
+    double io = best.phase_ms[PH_IO] + best_load;
+    double other = max(0.0, best_wall - io - best.phase_ms[PH_SCHED] - best.phase_ms[PH_SAMPLE] - best.phase_ms[PH_ANALYSIS]);
+    long long rss = peak_rss_kb();
+    string source = trace.empty() ? "generated:" + to_string(spec.count) + ":seed" + to_string(spec.seed) : trace;
+    auto pct = [&](double ms){ ostringstream o; o << fixed << setprecision(1) << ms << " ms (" << 100 * ms / max(best_wall, 1e-9) << "%)"; return o.str(); };
+    cout << "\nBench: " << source << ", " << best.processes << " processes, policy " << policy << ", " << best.cores
+         << " core(s), best of " << repeat << "\n" << fixed
+         << "  events:              " << best.events << " (" << setprecision(0) << events_per_s << " events/s)\n"
+         << "  simulated:           " << setprecision(1) << best.end_time << " ms in " << best_wall << " ms wall ("
+         << setprecision(3) << best_wall / max(sim_s, 1e-9) << " ms wall per simulated second)\n"
+         << "  peak RSS:            " << rss << " kb\n"
+         << "  scheduling:          " << pct(best.phase_ms[PH_SCHED]) << "\n"
+         << "  sampling:            " << pct(best.phase_ms[PH_SAMPLE]) << "\n"
+         << "  analysis:            " << pct(best.phase_ms[PH_ANALYSIS]) << "\n"
+         << "  I/O (load + output): " << pct(io) << "\n"
+         << "  setup and other:     " << pct(other) << "\n";
+    if(!out_path.empty()){
+        bool fresh = !ifstream(out_path).good() || ifstream(out_path).peek() == EOF;
+        ofstream out(out_path, ios::app);
+        if(!out) throw runtime_error("Cannot create " + out_path);
+        if(fresh) out << "source,policy,cores,processes,events,sim_ms,wall_ms,events_per_s,wall_ms_per_sim_s,peak_rss_kb,"
+                         "sched_ms,sample_ms,analysis_ms,io_ms,other_ms\n";
+        out << fixed << setprecision(3) << source << "," << policy << "," << best.cores << "," << best.processes << ","
+            << best.events << "," << best.end_time << "," << best_wall << "," << events_per_s << ","
+            << best_wall / max(sim_s, 1e-9) << "," << rss << "," << best.phase_ms[PH_SCHED] << ","
+            << best.phase_ms[PH_SAMPLE] << "," << best.phase_ms[PH_ANALYSIS] << "," << io << "," << other << "\n";
+        cout << "Appended to " << out_path << "\n";
+    }
+    return 0;
+}
+
+static void usage(const char* prog){
+    cerr<<"Usage: "<<prog<<" [--policy fcfs|rr|srtf|priority|mlfq|cfs|edf] [--stream] [--retention MS]\n"
+        <<"       "<<string(strlen(prog), ' ')<<" [--archive MS] [trace.txt|trace.bin]\n"
+        <<"       "<<string(strlen(prog), ' ')<<" [--quantum MS] [--interval MS] [--window MS] [--reg-points N] [--horizon MS]\n"
+        <<"       "<<string(strlen(prog), ' ')<<" [--cores N] [--io-block] [--top K] [--quiet | --verbosity quiet|brief|full] [--json FILE]\n"
+        <<"       "<<string(strlen(prog), ' ')<<" [--hot-cpu MS] [--hot-rem MS] [--cpu-bound FRAC] [--io-bound W]\n"
+        <<"       "<<string(strlen(prog), ' ')<<" [--forecast linear|ewma|holt|hw] [--forecast-step MS] [--season MS] [--smoothing A,B,G]\n"
+        <<"       "<<prog<<" batch [options] [--jobs N] [--out DIR] <trace|dir>...\n"
+        <<"       "<<prog<<" sweep [--policy P,..] [--cores L] [--quantum L] [--interval L] [--window L] [--reg-points L]\n"
+        <<"       "<<string(strlen(prog), ' ')<<"       [--horizon L] [--jobs N] [--out FILE] [trace]\n"
+        <<"       "<<prog<<" bench [options] [--count N] [--seed S] [--repeat R] [--out FILE] [trace]\n"
+        <<"       "<<prog<<" convert <trace.txt> <trace.bin>\n"
+        <<"       "<<prog<<" generate [--count N] [--seed S] [--rate R] [--diurnal A] [--period MS]\n"
+        <<"       "<<string(strlen(prog), ' ')<<"          [--burst D] [--mem D] [--io D] <out.txt|out.bin>...\n"
+        <<"  --stream     read an arrival-sorted trace lazily, keeping only live processes in memory\n"
+        <<"  --retention  keep this much sampled history in memory (default 1000 ms)\n"
+        <<"  --archive    also keep min/max/mean per MS bucket for the whole run, saved to analysis_history.csv\n"
+        <<"  --quantum    base time slice (default 10 ms); --interval: analysis period (default 100 ms)\n"
+        <<"  --window     CPU util averaging window (default 200 ms); --reg-points: samples in the memory\n"
+        <<"               slope fit (default 10); --horizon: memory forecast lead time (default 500 ms)\n"
+        <<"  --cores      simulate N CPUs with per-core run queues and work stealing; per-core util goes\n"
+        <<"               to analysis_cores.csv (default 1)\n"
+        <<"  --io-block   jobs block off the CPU for their I/O share after each slice instead of running slower\n"
+        <<"  --top        report the K largest CPU consumers per tick; analysis.csv gets K pid/cpu column pairs (default 3)\n"
+        <<"  --hot-cpu    hotspot rule: more than MS of CPU used (default 100) and, --hot-rem, more than MS\n"
+        <<"               of work left (default 50)\n"
+        <<"  --cpu-bound  classify as CPU-bound above this share of the burst used (default 0.7), else\n"
+        <<"               --io-bound: IO-bound above this io_weight (default 0.6), else Mixed\n"
+        <<"  --verbosity  per-tick text: full (default), brief (no per-process lists) or quiet (none, only the\n"
+        <<"               CSVs and a one-line summary); --quiet is --verbosity quiet\n"
+        <<"  --json       also write each tick and a final summary as JSON lines to FILE (batch: report_<name>.jsonl)\n"
+        <<"  --forecast   memory model reported as forecast_kb: linear (slope fit, default), ewma, holt (trend)\n"
+        <<"               or hw (Holt-Winters, trend + season). All are scored; the JSON, the sweep results and an\n"
+        <<"               end-of-run line (given --forecast, or below full verbosity) give each one's mean\n"
+        <<"               absolute error. The smoothing models read memory every --forecast-step MS (default 10)\n"
+        <<"               with a --season of MS (default 1000) and level, trend, season factors --smoothing A,B,G\n"
+        <<"               in (0,1] (default 0.2,0.001,0.3)\n"
+        <<"  batch        simulate many traces in parallel (default: one thread per core, output to batch_out)\n"
+        <<"  sweep        simulate every combination of the given values (L = a,b,c or lo:hi:step) in\n"
+        <<"               parallel; one row per combination in sweep_results.csv\n"
+        <<"  bench        time the whole pipeline on the trace, or on a generated workload of N jobs (default\n"
+        <<"               100000, seed 1; see generate); best of R runs (default 3): events/s, wall per\n"
+        <<"               simulated second, peak RSS and the scheduling/sampling/analysis/I/O split.\n"
+        <<"               Quiet unless --verbosity is given; --out appends a CSV row for comparing builds\n"
+        <<"  convert      write a text trace in the binary columnar format (loaded by mmap, no parsing)\n"
+        <<"  generate     write a seeded synthetic trace (arrival-sorted; .bin outputs binary, others text):\n"
+        <<"               N jobs (default 1000), Poisson arrivals at R per ms (default 0.05) swinging by A\n"
+        <<"               (0..1, default 0) over a period (default one day). D is kind:params, one of\n"
+        <<"               const:v uniform:lo,hi exp:mean normal:m,sd lognormal:mu,sigma pareto:alpha,lo,hi\n"
+        <<"               bimodal:p,m1,s1,m2,s2 iomix:p_cpu,p_io; defaults --burst pareto:1.5,5,5000\n"
+        <<"               --mem bimodal:0.8,8000,3000,200000,50000 --io iomix:0.5,0.3\n";
+}
+
+static int convert_trace(const string& in, const string& out){
+    ProcessTable table;
+    load_trace(in, table);
+    write_binary_trace(out, table);
+    cout<<"Wrote "<<table.size()<<" jobs to "<<out<<"\n";
+    return 0;
+}
+
+// every output gets the same rows: one generator per file, same seed
+static int generate_trace(const WorkloadSpec& spec, const vector<string>& outs){
+    for(auto &path: outs){
+        bool binary = path.size() >= 4 && path.compare(path.size()-4, 4, ".bin") == 0;
+        WorkloadGen gen(spec);
+        TraceWriter w;
+        w.open(path, binary, spec.count);
+        TraceRow r;
+        while(gen.next(r)) w.add(r);
+        w.close();
+        cout<<"Wrote "<<spec.count<<" jobs (last arrival t="<<(long long)round(gen.t)<<" ms) to "<<path<<"\n";
+    }
+    return 0;
+}
+
 int main(int argc, char** argv){
     ios::sync_with_stdio(false); cin.tie(nullptr);
-    vector<tuple<double,double,double,double>> jobs;
-    if(argc>1){
-        // expect path relative to project root, e.g. traces\sample_burst.txt
-        ifstream ifs(argv[1]);
-        if(!ifs){ cerr<<"Cannot open "<<argv[1]<<"\n"; return 1; }
-        double a,b,m,io;
-        while(ifs>>a>>b>>m>>io) jobs.emplace_back(a,b,m,io);
-    } else {
-        jobs = sample_jobs();
-        cout<<"No trace file given — using sample jobset.\n";
-    }
-    Simulator sim; sim.load(jobs); sim.run_and_analyze();
+    if(argc>1 && string(argv[1])=="convert"){
+        if(argc!=4){ usage(argv[0]); return 1; }
+        try { return convert_trace(argv[2], argv[3]); }
+        catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    }
+    if(argc>1 && string(argv[1])=="generate"){
+        WorkloadSpec spec;
+        vector<string> outs;
+        try {
+            for(int i=2;i<argc;++i){
+                string arg = argv[i];
+                bool val = i+1<argc;
+                if(arg=="--count" && val) spec.count = stoull(argv[++i]);
+                else if(arg=="--seed" && val) spec.seed = stoull(argv[++i]);
+                else if(arg=="--rate" && val) spec.rate = atof(argv[++i]);
+                else if(arg=="--diurnal" && val) spec.diurnal = atof(argv[++i]);
+                else if(arg=="--period" && val) spec.period_ms = atof(argv[++i]);
+                else if(arg=="--burst" && val) spec.burst = Dist::parse(argv[++i]);
+                else if(arg=="--mem" && val) spec.mem = Dist::parse(argv[++i]);
+                else if(arg=="--io" && val) spec.io = Dist::parse(argv[++i]);
+                else if(arg.rfind("--",0)==0){ usage(argv[0]); return 1; }
+                else outs.push_back(arg);
+            }
+            if(outs.empty()){ usage(argv[0]); return 1; }
+            if(!(spec.rate > 0)) throw runtime_error("rate must be > 0");
+            if(!(spec.diurnal >= 0 && spec.diurnal <= 1)) throw runtime_error("diurnal amplitude must be in [0, 1]");
+            if(!(spec.period_ms > 0)) throw runtime_error("period must be > 0");
+            return generate_trace(spec, outs);
+        } catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    }
+    bool batch = argc>1 && string(argv[1])=="batch";
+    bool sweep = argc>1 && string(argv[1])=="sweep";
+    bool bench = argc>1 && string(argv[1])=="bench";
+    string policy = SrtfPolicy::name, trace, out_dir = batch ? "batch_out" : bench ? "" : "sweep_results.csv";
+    vector<string> inputs;
+    unsigned threads = default_threads();
+    bool streaming = false, forecast_given = false;
+    SimOptions opt;
+    WorkloadSpec bench_spec; bench_spec.count = 100000;
+    int repeat = 3;
+    if(bench) opt.verbosity = VERB_QUIET;
+    // model parameters: one value each, or a value list under sweep
+    map<string,string> params = {{"--quantum","10"}, {"--interval","100"}, {"--window","200"},
+                                 {"--reg-points","10"}, {"--horizon","500"}, {"--cores","1"}};
+    for(int i=(batch||sweep||bench)?2:1;i<argc;++i){
+        string arg = argv[i];
+        if((batch||sweep) && arg=="--jobs" && i+1<argc){ threads = (unsigned)max(1, atoi(argv[++i])); continue; }
+        if((batch||sweep||bench) && arg=="--out" && i+1<argc){ out_dir = argv[++i]; continue; }
+        if(bench && arg=="--count" && i+1<argc){ bench_spec.count = strtoull(argv[++i], nullptr, 10); continue; }
+        if(bench && arg=="--seed" && i+1<argc){ bench_spec.seed = strtoull(argv[++i], nullptr, 10); continue; }
+        if(bench && arg=="--repeat" && i+1<argc){ repeat = max(1, atoi(argv[++i])); continue; }
+        if(params.count(arg) && i+1<argc){ params[arg] = argv[++i]; continue; }
+        if(arg=="--policy" && i+1<argc) policy = argv[++i];
+        else if(arg=="--stream" && !sweep) streaming = true;
+        else if(arg=="--io-block") opt.io_blocking = true;
+        else if(arg=="--top" && i+1<argc) opt.top_k = (size_t)max(0, atoi(argv[++i]));
+        else if(arg=="--hot-cpu" && i+1<argc) opt.rules.hot_cpu_ms = atof(argv[++i]);
+        else if(arg=="--hot-rem" && i+1<argc) opt.rules.hot_remaining_ms = atof(argv[++i]);
+        else if(arg=="--cpu-bound" && i+1<argc) opt.rules.cpu_bound_frac = atof(argv[++i]);
+        else if(arg=="--io-bound" && i+1<argc) opt.rules.io_bound_weight = atof(argv[++i]);
+        else if(arg=="--quiet") opt.verbosity = VERB_QUIET;
+        else if(arg=="--verbosity" && i+1<argc){
+            string v = argv[++i];
+            if(v=="quiet" || v=="0") opt.verbosity = VERB_QUIET;
+            else if(v=="brief" || v=="1") opt.verbosity = VERB_BRIEF;
+            else if(v=="full" || v=="2") opt.verbosity = VERB_FULL;
+            else { usage(argv[0]); return 1; }
+        }
+        else if(arg=="--json" && i+1<argc && !sweep) opt.json_path = argv[++i];
+        else if(arg=="--forecast" && i+1<argc){
+            forecast_given = true;
+            opt.forecast.model = parse_forecast_model(argv[++i]);
+            if(opt.forecast.model < 0){ cerr<<"Unknown forecast model "<<argv[i]<<"\n"; usage(argv[0]); return 1; }
+        }
+        else if(arg=="--forecast-step" && i+1<argc) opt.forecast.step_ms = atof(argv[++i]);
+        else if(arg=="--season" && i+1<argc) opt.forecast.season_ms = atof(argv[++i]);
+        else if(arg=="--smoothing" && i+1<argc){
+            ForecastParams &f = opt.forecast;
+            if(sscanf(argv[++i], "%lf,%lf,%lf", &f.alpha, &f.beta, &f.gamma) != 3){ usage(argv[0]); return 1; }
+        }
+        else if(arg=="--retention" && i+1<argc) opt.retention_ms = atof(argv[++i]);
+        else if(arg=="--archive" && i+1<argc) opt.archive_bucket_ms = atof(argv[++i]);
+        else if(arg.rfind("--",0)==0){ usage(argv[0]); return 1; }
+        else if(batch) inputs.push_back(arg);
+        else trace = arg;
+    }
+    SweepGrid grid;
+    try {
+        grid.quantum = parse_values(params["--quantum"]);
+        grid.interval = parse_values(params["--interval"]);
+        grid.window = parse_values(params["--window"]);
+        grid.horizon = parse_values(params["--horizon"]);
+        for(double v: parse_values(params["--reg-points"])) grid.reg_points.push_back((size_t)max(0.0, v));
+        for(double v: parse_values(params["--cores"])) grid.cores.push_back((int)max(0.0, min(v, 1e6)));
+    } catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    if(sweep){
+        stringstream ss(policy); string p;
+        while(getline(ss, p, ',')){
+            if(!policy_runner(p)){ cerr<<"Unknown policy "<<p<<"\n"; usage(argv[0]); return 1; }
+            grid.policies.push_back(p);
+        }
+        try { return run_sweep(trace, grid, opt, threads, out_dir); }
+        catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    }
+    if(grid.quantum.size()>1 || grid.interval.size()>1 || grid.window.size()>1 || grid.horizon.size()>1 ||
+       grid.reg_points.size()>1 || grid.cores.size()>1){ cerr<<"Value lists need the sweep subcommand\n"; return 1; }
+    opt.quantum = grid.quantum[0]; opt.analysis_interval = grid.interval[0]; opt.util_window_ms = grid.window[0];
+    opt.regression_points = grid.reg_points[0]; opt.forecast_horizon_ms = grid.horizon[0]; opt.cores = grid.cores[0];
+    string bad = invalid_option(opt);
+    if(!bad.empty()){ cerr<<"Error: "<<bad<<"\n"; return 1; }
+    SimulateFn run = policy_runner(policy);
+    if(!run){ cerr<<"Unknown policy "<<policy<<"\n"; usage(argv[0]); return 1; }
+    if(batch){
+        if(inputs.empty()){ usage(argv[0]); return 1; }
+        try { return run_batch(inputs, run, opt, streaming, threads, out_dir); }
+        catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    }
+    if(streaming && trace.empty()){ cerr<<"--stream needs a trace file\n"; return 1; }
+    if(bench){
+        try { return run_bench_mode(trace, policy, run, opt, streaming, bench_spec, repeat, out_dir); }
+        catch(const exception& e){ cerr<<"Error: "<<e.what()<<"\n"; return 1; }
+    }
+
+    ProcessTable table;
+    TraceStream stream;
+    try {
+        if(streaming){
+            if(!stream.open(trace)){ cerr<<"Cannot open "<<trace<<"\n"; return 1; }
+        } else if(!trace.empty()){
+            // expect path relative to project root, e.g. traces\sample_burst.txt
+            load_trace(trace, table);
+        } else {
+            table = table_from_jobs(sample_jobs());
+            cout<<"No trace file given — using sample jobset.\n";
+        }
+        RunSummary sum = run(table, streaming ? &stream : nullptr, opt);
+        if(opt.verbosity < VERB_FULL){
+            cout<<"Simulated "<<sum.processes<<" processes ("<<sum.completed<<" completed) to t="<<(long long)round(sum.end_time)
+                <<" ms: avg turnaround "<<fixed<<setprecision(2)<<sum.avg_turnaround<<" ms, peak mem "
+                <<(long long)round(sum.peak_mem)<<" kb\n";
+        }
+        // the full per-tick text already shows the forecasts; keep its output unchanged unless asked
+        if(opt.verbosity < VERB_FULL || forecast_given){
+            cout<<"Memory forecast MAE over "<<sum.forecasts_checked<<" forecasts ("<<(long long)round(opt.forecast_horizon_ms)<<" ms ahead):";
+            for(int m=0;m<FC_COUNT;++m) cout<<" "<<forecast_model_name(m)<<"="<<(long long)round(sum.model_mae[m]);
+            cout<<" kb (reported: "<<forecast_model_name(sum.forecast_model)<<")\n";
+        }
+    } catch(const exception& e){
+        cerr<<"Error: "<<e.what()<<"\n"; return 1;
+    }
     cout<<"\nSimulation finished. CSV saved to analysis.csv (in current folder).\n";
+    if(!opt.json_path.empty()) cout<<"JSON lines report saved to "<<opt.json_path<<"\n";
     return 0;
 }
+#endif // AIPO_NO_MAIN
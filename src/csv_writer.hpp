@@ -0,0 +1,164 @@
+// src/csv_writer.hpp
+// CSV output off the simulation thread. Rows are formatted with to_chars
+// straight into fixed-size chunks; a full chunk is handed through a
+// lock-free single-producer/single-consumer queue to a writer thread, which
+// writes it out and hands the empty chunk back through a second queue for
+// reuse. The simulation thread only formats and pushes pointers; it waits
+// only if the writer falls a whole queue of chunks behind. The JSON lines
+// report goes through the same writer using the unseparated put() calls.
+// Every run starts writer threads, so build with -pthread (glibc before 2.34
+// fails at run time without it).
+#pragma once
+#include <bits/stdc++.h>
+#include "instrument.hpp"
+using namespace std;
+
+// Bounded lock-free ring for exactly one producer and one consumer thread.
+// Capacity must be a power of two.
+template<class T, size_t CAP>
+struct SpscQueue {
+    static_assert((CAP & (CAP-1)) == 0, "SpscQueue capacity must be a power of two");
+    array<T, CAP> items;
+    alignas(64) atomic<size_t> head{0}; // next slot to pop, advanced by the consumer
+    alignas(64) atomic<size_t> tail{0}; // next slot to push, advanced by the producer
+
+    bool push(const T& v){
+        size_t t = tail.load(memory_order_relaxed);
+        if(t - head.load(memory_order_acquire) == CAP) return false;
+        items[t & (CAP-1)] = v;
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+    bool pop(T& v){
+        size_t h = head.load(memory_order_relaxed);
+        if(h == tail.load(memory_order_acquire)) return false;
+        v = items[h & (CAP-1)];
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+};
+
+struct AsyncCsvWriter {
+    static const size_t CHUNK_BYTES = 64 * 1024;
+    static const size_t MAX_FIELD = 64; // longest formatted number, with its comma
+    struct Chunk { size_t used = 0; char data[CHUNK_BYTES]; };
+
+    FILE* file = nullptr;
+    thread writer;
+    atomic<bool> closing{false};
+    // new chunks are only allocated while free_q is empty, so at most
+    // 256 + 2 exist and free_q can always take them all back
+    SpscQueue<Chunk*, 256> full_q; // to the writer
+    SpscQueue<Chunk*, 512> free_q; // back to the producer
+    vector<unique_ptr<Chunk>> chunks;      // every chunk ever allocated (producer side)
+    Chunk* cur = nullptr;
+    bool row_start = true;
+
+    AsyncCsvWriter() {}
+    AsyncCsvWriter(const AsyncCsvWriter&) = delete;
+    AsyncCsvWriter& operator=(const AsyncCsvWriter&) = delete;
+    ~AsyncCsvWriter(){ close(); }
+
+    bool open(const string& path){
+        close();
+        file = fopen(path.c_str(), "w");
+        if(!file) return false;
+        closing = false;
+        cur = take_chunk();
+        row_start = true;
+        writer = thread([this]{ drain(); });
+        return true;
+    }
+    bool is_open() const { return file != nullptr; }
+    // flushes everything written so far and stops the writer thread
+    void close(){
+        if(!file) return;
+        hand_off();
+        closing = true;
+        writer.join();
+        fclose(file);
+        file = nullptr;
+        Chunk* c;
+        while(free_q.pop(c)){}
+        chunks.clear();
+        cur = nullptr;
+    }
+
+    // raw text, e.g. the header line
+    void write(const char* s){
+        for(size_t n = strlen(s); n > 0;){
+            room(1);
+            size_t k = min(n, CHUNK_BYTES - cur->used);
+            memcpy(cur->data + cur->used, s, k);
+            cur->used += k; s += k; n -= k;
+        }
+    }
+    template<class I, typename enable_if<is_integral<I>::value, int>::type = 0>
+    void add(I v){ sep(); put(v); }
+    template<class I, typename enable_if<is_integral<I>::value, int>::type = 0>
+    void put(I v){
+        room(MAX_FIELD);
+        cur->used = to_chars(cur->data + cur->used, cur->data + CHUNK_BYTES, v).ptr - cur->data;
+    }
+    // shortest text that reads back as the same double
+    void put(double v){
+        room(MAX_FIELD);
+        cur->used = to_chars(cur->data + cur->used, cur->data + CHUNK_BYTES, v).ptr - cur->data;
+    }
+    // fixed notation with `precision` decimals, as printf("%.*f")
+    void add(double v, int precision){
+        sep();
+        auto r = to_chars(cur->data + cur->used, cur->data + CHUNK_BYTES, v, chars_format::fixed, precision);
+        if(r.ec != errc()){ // too long for a field (|v| > 1e50 or so): fall back to scientific
+            r = to_chars(cur->data + cur->used, cur->data + CHUNK_BYTES, v, chars_format::scientific, precision);
+        }
+        cur->used = r.ptr - cur->data;
+    }
+    void end_row(){
+        room(1);
+        cur->data[cur->used++] = '\n';
+        row_start = true;
+    }
+
+private:
+    void sep(){
+        room(MAX_FIELD);
+        if(!row_start) cur->data[cur->used++] = ',';
+        row_start = false;
+    }
+    void room(size_t n){ if(CHUNK_BYTES - cur->used < n) hand_off(); }
+    Chunk* take_chunk(){
+        Chunk* c;
+        if(free_q.pop(c)){ c->used = 0; return c; }
+        chunks.emplace_back(new Chunk());
+        return chunks.back().get();
+    }
+    void hand_off(){
+        if(cur->used == 0) return;
+        AIPO_PROF_SCOPE("csv.hand_off");
+        while(!full_q.push(cur)) this_thread::yield(); // writer is a full queue behind
+        cur = take_chunk();
+    }
+    // writer thread: write chunks in order and return them; when idle, back
+    // off from 50 us to 5 ms between polls
+    void drain(){
+        Chunk* c;
+        int idle_us = 50;
+        for(;;){
+            bool done = closing.load(memory_order_acquire); // set after the last hand-off
+            if(full_q.pop(c)){
+                {
+                    AIPO_PROF_SCOPE("csv.fwrite");
+                    fwrite(c->data, 1, c->used, file);
+                }
+                AIPO_PROF_COUNT("csv.bytes", c->used);
+                free_q.push(c);
+                idle_us = 50;
+                continue;
+            }
+            if(done) break;
+            this_thread::sleep_for(chrono::microseconds(idle_us));
+            idle_us = min(idle_us * 2, 5000);
+        }
+    }
+};
@@ -0,0 +1,111 @@
+// src/event_queue.hpp
+// Pending-event set for the discrete-event simulator: a hierarchical timer
+// wheel. Times are bucketed into ticks of `res` ms; LEVELS wheels of SLOTS
+// slots each cover SLOTS^LEVELS ticks ahead of the current tick, and anything
+// further out waits in an overflow heap. A push is O(1), a pop is amortized
+// O(1) plus a small heap over the events of the current tick, which keeps
+// them in exact (time, prio, seq) order: the tick only decides the bucket,
+// never the order, so same-time events pop by priority and then FIFO.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+inline int highest_bit64(uint64_t m){
+#ifdef _MSC_VER
+    unsigned long b; _BitScanReverse64(&b, m); return (int)b;
+#else
+    return 63 - __builtin_clzll(m);
+#endif
+}
+inline int lowest_bit64(uint64_t m){
+#ifdef _MSC_VER
+    unsigned long b; _BitScanForward64(&b, m); return (int)b;
+#else
+    return __builtin_ctzll(m);
+#endif
+}
+
+template<class T>
+struct TimerWheel {
+    static const int BITS = 6, SLOTS = 1 << BITS, LEVELS = 4;
+    struct Item {
+        double time; int prio; uint64_t seq; T val;
+        bool operator>(const Item& o) const {
+            if(time != o.time) return time > o.time;
+            if(prio != o.prio) return prio > o.prio;
+            return seq > o.seq;
+        }
+    };
+    double res;
+    uint64_t now_tick = 0; // every pending item has tick >= now_tick
+    uint64_t seq = 0;
+    size_t n = 0;
+    vector<Item> slots[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS] = {};
+    priority_queue<Item, vector<Item>, greater<Item>> due, overflow; // current tick / beyond the wheels
+
+    explicit TimerWheel(double res_ms = 1.0) : res(res_ms) {}
+
+    void clear(){
+        for(auto &level: slots) for(auto &s: level) s.clear();
+        memset(occupied, 0, sizeof occupied);
+        due = decltype(due)(); overflow = decltype(overflow)();
+        now_tick = seq = 0; n = 0;
+    }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    // lower prio pops first among events at the same time
+    void push(double time, T val, int prio = 0){
+        place(Item{time, prio, seq++, val});
+        n++;
+    }
+    // earliest event; false when there is none
+    bool pop(double& time, T& val){
+        if(n == 0) return false;
+        while(due.empty()) advance();
+        time = due.top().time; val = due.top().val;
+        due.pop(); n--;
+        return true;
+    }
+
+private:
+    uint64_t tick_of(double t) const {
+        double k = floor(t / res);
+        return k <= (double)now_tick ? now_tick : (uint64_t)k; // never behind the wheel
+    }
+    void place(const Item& it){
+        uint64_t tick = tick_of(it.time);
+        if(tick == now_tick){ due.push(it); return; }
+        int level = highest_bit64(tick ^ now_tick) / BITS;
+        if(level >= LEVELS){ overflow.push(it); return; }
+        int slot = (int)((tick >> (BITS*level)) & (SLOTS-1));
+        slots[level][slot].push_back(it);
+        occupied[level] |= 1ULL << slot;
+    }
+    // moves now_tick to the next occupied slot and redistributes its items
+    void advance(){
+        for(int level=0;level<LEVELS;++level){
+            int cur = (int)((now_tick >> (BITS*level)) & (SLOTS-1));
+            uint64_t later = cur == SLOTS-1 ? 0 : occupied[level] & (~0ULL << (cur+1));
+            if(!later) continue;
+            int slot = lowest_bit64(later);
+            uint64_t span = BITS*(level+1) >= 64 ? 0 : ~0ULL << (BITS*(level+1));
+            now_tick = (now_tick & span) | ((uint64_t)slot << (BITS*level));
+            vector<Item> items; items.swap(slots[level][slot]);
+            occupied[level] &= ~(1ULL << slot);
+            for(auto &it: items) place(it);
+            return;
+        }
+        // wheels empty: jump to the earliest overflow item and pull in everything now in range
+        now_tick = tick_of(overflow.top().time);
+        vector<Item> items;
+        while(!overflow.empty() && (tick_of(overflow.top().time) ^ now_tick) >> (BITS*LEVELS) == 0){
+            items.push_back(overflow.top()); overflow.pop();
+        }
+        for(auto &it: items) place(it);
+    }
+};
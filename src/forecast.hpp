@@ -0,0 +1,150 @@
+// src/forecast.hpp
+// Exponential-smoothing memory forecasters, each updated in O(1) per point.
+// Memory is sampled at event times (irregular) and holds its value between
+// samples, so the models read it on a fixed grid: every step ms the series
+// gets the last value sampled before that instant. One grid feeds all of
+// them, so their errors can be compared on the same run.
+#pragma once
+#include "process.hpp"
+
+enum ForecastModel { FC_LINEAR, FC_EWMA, FC_HOLT, FC_HW, FC_COUNT }; // linear: the regression slope fit
+
+inline const char* forecast_model_name(int m){
+    static const char* names[FC_COUNT] = {"linear", "ewma", "holt", "holt_winters"};
+    return names[m];
+}
+// -1 when unknown; "hw" is short for holt_winters
+inline int parse_forecast_model(const string& s){
+    for(int m=0;m<FC_COUNT;++m) if(s == forecast_model_name(m)) return m;
+    return s == "hw" ? FC_HW : -1;
+}
+
+struct ForecastParams {
+    int model = FC_LINEAR;   // the one reported as forecast_kb
+    double step_ms = 10;     // grid spacing the smoothing models see
+    double season_ms = 1000; // Holt-Winters period, rounded to whole steps
+    // level, trend and season smoothing, per step, and the Holt-Winters trend
+    // damping. The defaults keep Holt-Winters stable (disturbances die out)
+    // for seasons of 10 to 1000 steps; a larger beta or alpha with a long
+    // season can make it diverge, e.g. 0.5,0.01,0.1 at 1000 steps.
+    double alpha = 0.2, beta = 0.001, gamma = 0.3;
+    double phi = 0.98;
+};
+
+// level only: y(t+k) = level
+struct EwmaModel {
+    double alpha = 0.2, level = 0;
+    size_t n = 0;
+    void clear(){ level = 0; n = 0; }
+    void add(double y){ level = n++ ? level + alpha * (y - level) : y; }
+    double forecast(double) const { return level; }
+};
+
+// level and trend (per step): y(t+k) = level + k * trend
+struct HoltModel {
+    double alpha = 0.2, beta = 0.001, level = 0, trend = 0;
+    size_t n = 0;
+    void clear(){ level = trend = 0; n = 0; }
+    void add(double y){
+        if(n++ == 0){ level = y; return; }
+        if(n == 2){ trend = y - level; level = y; return; }
+        double prev = level;
+        level = alpha * y + (1 - alpha) * (level + trend);
+        trend = beta * (level - prev) + (1 - beta) * trend;
+    }
+    double forecast(double k) const { return level + k * trend; }
+};
+
+// additive Holt-Winters with a season of m steps and a damped trend:
+// y(t+k) = level + (phi + ... + phi^k) * trend + season[(t+k) mod m]. A line
+// fitted to the first season gives the initial level and trend and the
+// seasonal offsets are the residuals, so a series that is only trending
+// starts with no seasonality. Until then it forecasts the last value.
+// After every season the offsets are re-centred on zero (their mean moves
+// into the level); without that, level and season sum drift against each
+// other and the forecast never settles on a flat series. O(m) once per
+// season, O(1) amortized per point.
+struct HoltWintersModel {
+    double alpha = 0.2, beta = 0.001, gamma = 0.3, phi = 0.98, level = 0, trend = 0;
+    vector<double> season{0};
+    size_t n = 0;
+    void configure(size_t m){ season.assign(max<size_t>(m, 1), 0); clear(); }
+    void clear(){ level = trend = 0; n = 0; fill(season.begin(), season.end(), 0); }
+    void add(double y){
+        size_t m = season.size(), i = n % m;
+        if(n < m){
+            season[n++] = y;
+            if(n == m){
+                double mx = (m - 1) / 2.0, my = accumulate(season.begin(), season.end(), 0.0) / m, sxx = 0, sxy = 0;
+                for(size_t j=0;j<m;++j){ sxx += (j - mx) * (j - mx); sxy += (j - mx) * (season[j] - my); }
+                trend = sxx > 0 ? sxy / sxx : 0;
+                for(size_t j=0;j<m;++j) season[j] -= my + trend * (j - mx);
+                level = my + trend * mx; // the line at the last point
+            }
+            return;
+        }
+        double prev = level;
+        level = alpha * (y - season[i]) + (1 - alpha) * (level + phi * trend);
+        trend = beta * (level - prev) + (1 - beta) * phi * trend;
+        season[i] = gamma * (y - level) + (1 - gamma) * season[i];
+        n++;
+        if(i == m - 1){
+            double mean = accumulate(season.begin(), season.end(), 0.0) / m;
+            for(double &s: season) s -= mean;
+            level += mean;
+        }
+    }
+    double forecast(double k) const {
+        size_t m = season.size();
+        if(n == 0) return 0;
+        if(n < m) return season[n-1];
+        double damped = phi < 1 ? phi * (1 - pow(phi, k)) / (1 - phi) : k;
+        return level + damped * trend + season[(n - 1 + (size_t)k) % m];
+    }
+};
+
+// The smoothing models on one grid. add() is O(1) plus one model update per
+// grid point passed, so O(run length / step) over a whole run however many
+// samples there are.
+struct MemForecasters {
+    double step = 10;
+    EwmaModel ewma;
+    HoltModel holt;
+    HoltWintersModel hw;
+    double t0 = 0, last = 0; // first sample time, latest sampled value
+    size_t fed = 0;          // grid points t0 + i * step fed so far
+    bool started = false;
+
+    void configure(const ForecastParams& p){
+        step = p.step_ms;
+        ewma.alpha = holt.alpha = hw.alpha = p.alpha;
+        holt.beta = hw.beta = p.beta;
+        hw.gamma = p.gamma; hw.phi = p.phi;
+        hw.configure((size_t)max(1.0, round(p.season_ms / p.step_ms)));
+        clear();
+    }
+    void clear(){ ewma.clear(); holt.clear(); hw.clear(); t0 = last = 0; fed = 0; started = false; }
+
+    // grid points before t hold the previous value; one at t waits, since
+    // more samples may land on the same instant
+    void advance(double t){
+        if(!started) return;
+        for(double g = t0 + fed * step; g < t; g = t0 + ++fed * step){ ewma.add(last); holt.add(last); hw.add(last); }
+    }
+    void add(double t, double v){
+        if(!started){ started = true; t0 = t; }
+        advance(t);
+        last = v;
+    }
+    // model m's value at time `target`; call advance(now) first
+    double forecast(int m, double target) const {
+        if(fed == 0) return last;
+        double k = max(1.0, round((target - (t0 + (fed - 1) * step)) / step)); // steps past the last grid point
+        switch(m){
+        case FC_EWMA: return ewma.forecast(k);
+        case FC_HOLT: return holt.forecast(k);
+        case FC_HW: return hw.forecast(k);
+        }
+        return last;
+    }
+};
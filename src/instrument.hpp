@@ -0,0 +1,103 @@
+// src/instrument.hpp
+// Hot-path instrumentation, compiled in only with -DAIPO_PROFILE; otherwise
+// every macro below expands to nothing. AIPO_PROF_SCOPE(name) times the rest
+// of the enclosing block (RAII), AIPO_PROF_COUNT(name, n) adds n to a
+// counter. Each thread accumulates into its own slots with no locking, read
+// from the TSC on x86, and merges them into the process totals when it
+// exits; the table is printed to stderr at program exit. Times are inclusive
+// (a step that dispatches includes its pick_next). The bench subcommand's
+// phase split is separate and always available (see PhaseClock).
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+#ifdef AIPO_PROFILE
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+inline uint64_t prof_ticks(){ return __rdtsc(); }
+#else
+inline uint64_t prof_ticks(){ return (uint64_t)chrono::steady_clock::now().time_since_epoch().count(); }
+#endif
+
+struct Profiler {
+    static const int MAX_SITES = 64;
+    struct Slot { uint64_t calls = 0, amount = 0; }; // amount: ticks for timers, the sum for counters
+    struct Site { string name; bool timer; };
+
+    mutex mu;
+    vector<Site> sites;
+    Slot total[MAX_SITES];
+    int threads[MAX_SITES] = {}; // threads that touched each site
+    uint64_t start_ticks = prof_ticks();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    static Profiler& get(){ static Profiler p; return p; }
+
+    // one id per name: every instantiation of a template shares its site
+    int add_site(const char* name, bool timer){
+        lock_guard<mutex> lk(mu);
+        for(size_t i=0;i<sites.size();++i) if(sites[i].name == name) return (int)i;
+        if(sites.size() == MAX_SITES) return MAX_SITES - 1; // full: the rest pile onto the last slot
+        sites.push_back({name, timer});
+        return (int)sites.size() - 1;
+    }
+    void merge(const Slot* s){
+        lock_guard<mutex> lk(mu);
+        for(int i=0;i<MAX_SITES;++i) if(s[i].calls){
+            total[i].calls += s[i].calls; total[i].amount += s[i].amount; threads[i]++;
+        }
+    }
+    ~Profiler(){ dump(cerr); }
+
+    void dump(ostream& os){
+        lock_guard<mutex> lk(mu);
+        double run_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        double ns_per_tick = run_ns / max<double>(1, (double)(prof_ticks() - start_ticks));
+        os << "\nProfile (-DAIPO_PROFILE, inclusive times over all threads, run " << fixed << setprecision(1)
+           << run_ns / 1e6 << " ms)\n" << left << setw(24) << "site" << right << setw(8) << "threads"
+           << setw(14) << "calls" << setw(14) << "total ms" << setw(12) << "avg ns" << setw(9) << "% run" << "\n";
+        for(size_t i=0;i<sites.size();++i) if(sites[i].timer){
+            double ns = total[i].amount * ns_per_tick;
+            os << left << setw(24) << sites[i].name << right << setw(8) << threads[i] << setw(14) << total[i].calls
+               << setprecision(1) << setw(14) << ns / 1e6 << setw(12) << ns / max<uint64_t>(1, total[i].calls)
+               << setw(9) << 100 * ns / max(1.0, run_ns) << "\n";
+        }
+        for(size_t i=0;i<sites.size();++i) if(!sites[i].timer){
+            os << left << setw(24) << sites[i].name << right << setw(8) << threads[i] << setw(14) << total[i].calls
+               << setw(14) << total[i].amount << "  (counter: updates, sum)\n";
+        }
+    }
+};
+
+struct ThreadProfile {
+    Profiler::Slot slots[Profiler::MAX_SITES];
+    ThreadProfile(){ Profiler::get(); } // constructed first, so it outlives every thread's table
+    ~ThreadProfile(){ Profiler::get().merge(slots); }
+};
+inline Profiler::Slot* prof_slots(){ thread_local ThreadProfile tp; return tp.slots; }
+
+struct ProfScope {
+    int site;
+    uint64_t t0;
+    explicit ProfScope(int s) : site(s), t0(prof_ticks()) {}
+    ~ProfScope(){ Profiler::Slot &sl = prof_slots()[site]; sl.calls++; sl.amount += prof_ticks() - t0; }
+};
+
+#define AIPO_PROF_CAT2(a, b) a##b
+#define AIPO_PROF_CAT(a, b) AIPO_PROF_CAT2(a, b)
+#define AIPO_PROF_SCOPE(name) \
+    static const int AIPO_PROF_CAT(aipo_site_, __LINE__) = Profiler::get().add_site(name, true); \
+    ProfScope AIPO_PROF_CAT(aipo_scope_, __LINE__)(AIPO_PROF_CAT(aipo_site_, __LINE__))
+#define AIPO_PROF_COUNT(name, n) do { \
+        static const int aipo_site_ = Profiler::get().add_site(name, false); \
+        Profiler::Slot &aipo_slot_ = prof_slots()[aipo_site_]; \
+        aipo_slot_.calls++; aipo_slot_.amount += (uint64_t)(n); \
+    } while(0)
+#else
+#define AIPO_PROF_SCOPE(name) do {} while(0)
+#define AIPO_PROF_COUNT(name, n) do {} while(0)
+#endif
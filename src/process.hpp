@@ -0,0 +1,59 @@
+// src/process.hpp
+// Process records, the process table and the time-series sample shared by
+// the simulator, the scheduler policies and the analyzer.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+struct Process {
+    int pid;
+    double arrival; // ms
+    double burst;   // ms total work
+    double remaining;
+    double mem_kb;  // simulated memory footprint
+    double io_weight; // 0..1
+    double start_time, finish_time;
+    double cpu_consumed; // ms
+    Process(int id=0,double a=0,double b=0,double m=0,double io=0)
+      :pid(id),arrival(a),burst(b),remaining(b),mem_kb(m),io_weight(io),
+       start_time(-1),finish_time(-1),cpu_consumed(0){}
+};
+
+// Structure-of-arrays process table. Hot columns, touched by scheduling,
+// sampling and every analysis pass, are contiguous arrays of their own so
+// those loops stream through only the fields they read; cold per-process
+// metadata is kept apart. Index i is the same process in every column.
+// Process is the row type for loading, copying and printing a whole entry.
+struct ProcessTable {
+    // hot
+    vector<double> remaining, arrival, io_weight, mem_kb, cpu_consumed;
+    // cold
+    vector<int> pid;
+    vector<double> burst, start_time, finish_time;
+
+    size_t size() const { return pid.size(); }
+    bool empty() const { return pid.empty(); }
+    void clear(){ resize(0); }
+    void reserve(size_t n){
+        remaining.reserve(n); arrival.reserve(n); io_weight.reserve(n); mem_kb.reserve(n); cpu_consumed.reserve(n);
+        pid.reserve(n); burst.reserve(n); start_time.reserve(n); finish_time.reserve(n);
+    }
+    void resize(size_t n){
+        remaining.resize(n); arrival.resize(n); io_weight.resize(n); mem_kb.resize(n); cpu_consumed.resize(n);
+        pid.resize(n); burst.resize(n); start_time.resize(n); finish_time.resize(n);
+    }
+    void push_back(const Process& p){ resize(size()+1); set(size()-1, p); }
+    void set(size_t i, const Process& p){
+        remaining[i] = p.remaining; arrival[i] = p.arrival; io_weight[i] = p.io_weight;
+        mem_kb[i] = p.mem_kb; cpu_consumed[i] = p.cpu_consumed;
+        pid[i] = p.pid; burst[i] = p.burst; start_time[i] = p.start_time; finish_time[i] = p.finish_time;
+    }
+    Process get(size_t i) const {
+        Process p(pid[i], arrival[i], burst[i], mem_kb[i], io_weight[i]);
+        p.remaining = remaining[i]; p.cpu_consumed = cpu_consumed[i];
+        p.start_time = start_time[i]; p.finish_time = finish_time[i];
+        return p;
+    }
+};
+
+struct SeriesPoint { double time; double value; };
@@ -0,0 +1,97 @@
+// src/process_index.hpp
+// Indexes over the process table that the simulator keeps current as
+// counters change, so analysis ticks read them instead of scanning every
+// process.
+#pragma once
+#include "process.hpp"
+
+// Processes ranked by cpu_consumed. Only those that have used CPU are kept,
+// in an ordered set updated at the end of each slice (O(log n)); the top K
+// then costs O(K) per tick. Order matches sorting every (cpu_consumed, index)
+// pair descending: more CPU first, ties by larger index.
+struct TopConsumers {
+    set<pair<double,int>> ranked;
+
+    void clear(){ ranked.clear(); }
+    void build(const ProcessTable& procs){
+        clear();
+        for(size_t i=0;i<procs.size();++i) if(procs.pid[i]>=0) add((int)i, procs.cpu_consumed[i]);
+    }
+    void add(int i, double cpu){ if(cpu > 0) ranked.insert({cpu, i}); }
+    void remove(int i, double cpu){ if(cpu > 0) ranked.erase({cpu, i}); }
+    void update(int i, double old_cpu, double cpu){
+        if(old_cpu == cpu) return;
+        remove(i, old_cpu); add(i, cpu);
+    }
+
+    // the k largest as (cpu_consumed, index) into out. Fewer than k have run:
+    // the rest are zero-CPU processes by descending index, found by scanning
+    // down from the end, which skips fewer than k run ones plus dead slots.
+    void top(size_t k, const ProcessTable& procs, vector<pair<double,int>>& out) const {
+        out.clear();
+        for(auto it = ranked.rbegin(); it != ranked.rend() && out.size() < k; ++it) out.push_back(*it);
+        for(size_t i = procs.size(); i-- > 0 && out.size() < k;){
+            if(procs.pid[i] >= 0 && !(procs.cpu_consumed[i] > 0)) out.push_back({procs.cpu_consumed[i], (int)i});
+        }
+    }
+};
+
+// Thresholds for the per-tick hotspot and classification report.
+struct ClassRules {
+    // hotspot: has used more than hot_cpu_ms and still has more than hot_remaining_ms of work
+    double hot_cpu_ms = 100, hot_remaining_ms = 50;
+    double cpu_bound_frac = 0.7;  // cpu_consumed / burst above this: CPU-bound
+    double io_bound_weight = 0.6; // otherwise io_weight above this: IO-bound, else Mixed
+};
+enum ProcClass { CLS_CPU, CLS_IO, CLS_MIXED, CLS_NONE }; // NONE: no CPU used yet, or a dead slot
+
+// Hotspots and per-class membership under a ClassRules. A process is
+// re-evaluated in O(1) whenever its counters change; the sets are touched
+// only when it crosses a threshold, so a tick reads counts in O(1) and lists
+// in O(listed). cpu_consumed only grows and remaining only shrinks, so each
+// process enters and leaves the hotspot set at most once and changes class
+// at most twice.
+struct ProcessClasses {
+    ClassRules rules;
+    set<int> hot;        // indices, ascending like a full scan
+    set<int> classified; // every index with a class
+    size_t count[3] = {0, 0, 0};
+    vector<signed char> cls; // per index
+    vector<char> is_hot;
+
+    void clear(){
+        hot.clear(); classified.clear();
+        count[0] = count[1] = count[2] = 0;
+        cls.clear(); is_hot.clear();
+    }
+    void build(const ProcessTable& procs){
+        clear();
+        for(size_t i=0;i<procs.size();++i) update(procs, (int)i);
+    }
+    const char* name(int c) const { return c == CLS_CPU ? "CPU-bound" : c == CLS_IO ? "IO-bound" : "Mixed"; }
+
+    int classify(const ProcessTable& p, int i) const {
+        double cpu = p.cpu_consumed[i];
+        if(p.pid[i] < 0 || !(cpu > 0)) return CLS_NONE;
+        if(cpu / max(1.0, p.burst[i]) > rules.cpu_bound_frac) return CLS_CPU;
+        return p.io_weight[i] > rules.io_bound_weight ? CLS_IO : CLS_MIXED;
+    }
+    bool hotspot(const ProcessTable& p, int i) const {
+        return p.pid[i] >= 0 && p.cpu_consumed[i] > rules.hot_cpu_ms && p.remaining[i] > rules.hot_remaining_ms;
+    }
+    // call after process i's counters change, or its slot is filled or released
+    void update(const ProcessTable& p, int i){
+        if((size_t)i >= cls.size()){ cls.resize(p.size(), CLS_NONE); is_hot.resize(p.size(), 0); }
+        int c = classify(p, i);
+        if(c != cls[i]){
+            if(cls[i] != CLS_NONE) count[cls[i]]--; else classified.insert(i);
+            if(c != CLS_NONE) count[c]++; else classified.erase(i);
+            cls[i] = (signed char)c;
+        }
+        bool h = hotspot(p, i);
+        if(h != (bool)is_hot[i]){
+            if(h) hot.insert(i); else hot.erase(i);
+            is_hot[i] = h;
+        }
+    }
+};
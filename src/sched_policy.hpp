@@ -0,0 +1,215 @@
+// src/sched_policy.hpp
+// Scheduler policies for Simulator<Policy>. There is no base class: the
+// simulator is a template over the policy, so every call below is resolved
+// at compile time and the step() loop is specialised per policy.
+//
+// A policy provides:
+//   static constexpr const char* name;
+//   void   reset(const ProcessTable& procs);           // per-run state
+//   void   admit(const ProcessTable& procs, int i, double now);   // process i arrived (or migrated
+//                                                         // here); in streaming mode i may be a
+//                                                         // reused slot
+//   int    pick(const ProcessTable& procs, double now);  // remove and return next index, -1 if none
+//   int    steal(const ProcessTable& procs);             // remove a job for migration, -1 if none
+//   double slice(int i, double quantum) const;            // max run length for the picked process i
+//   void   requeue(const ProcessTable& procs, int i, double ran, bool full_slice); // i still runnable
+//   void   finish(int i);                                 // i completed
+//
+// One policy instance is one run queue (one per simulated core). At most one
+// of its jobs runs at a time: pick, then slice and requeue/finish for that
+// job, so per-job state of the running job can live in the policy while
+// queued jobs carry theirs in the queue entries. A policy therefore holds
+// O(queued jobs), never O(all processes), and many cores stay cheap. steal
+// must leave the running job's state alone.
+//
+// The trace format carries no priority or deadline, so Priority and EDF
+// derive them from the job itself (see below).
+#pragma once
+#include "process.hpp"
+
+// First come first served, non-preemptive: the running job goes back to the
+// front of the FIFO until it completes.
+struct FcfsPolicy {
+    static constexpr const char* name = "fcfs";
+    deque<int> fifo;
+
+    void reset(const ProcessTable&){ fifo.clear(); }
+    void admit(const ProcessTable&, int i, double){ fifo.push_back(i); }
+    int pick(const ProcessTable&, double){
+        if(fifo.empty()) return -1;
+        int i = fifo.front(); fifo.pop_front(); return i;
+    }
+    int steal(const ProcessTable&){ // the newest arrival, furthest from running here
+        if(fifo.empty()) return -1;
+        int i = fifo.back(); fifo.pop_back(); return i;
+    }
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable&, int i, double, bool){ fifo.push_front(i); }
+    void finish(int){}
+};
+
+// Round robin: FIFO, a preempted job goes behind everything that arrived
+// during its quantum.
+struct RoundRobinPolicy {
+    static constexpr const char* name = "rr";
+    deque<int> fifo;
+
+    void reset(const ProcessTable&){ fifo.clear(); }
+    void admit(const ProcessTable&, int i, double){ fifo.push_back(i); }
+    int pick(const ProcessTable&, double){
+        if(fifo.empty()) return -1;
+        int i = fifo.front(); fifo.pop_front(); return i;
+    }
+    int steal(const ProcessTable&){
+        if(fifo.empty()) return -1;
+        int i = fifo.back(); fifo.pop_back(); return i;
+    }
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable&, int i, double, bool){ fifo.push_back(i); }
+    void finish(int){}
+};
+
+// Binary min-heap over (key, pid, index). Ties go to the lowest pid (trace
+// order), matching a linear scan with a strict '<' comparison even when
+// streaming reuses slots out of order.
+struct KeyedHeap {
+    typedef tuple<double,int,int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> heap;
+
+    void clear(){ heap = decltype(heap)(); }
+    bool empty() const { return heap.empty(); }
+    void push(double key, const ProcessTable& procs, int i){ heap.push({key, procs.pid[i], i}); }
+    int pop(){ int i = get<2>(heap.top()); heap.pop(); return i; }
+};
+
+// Shortest remaining time first (preemptive), keyed by remaining work.
+struct SrtfPolicy {
+    static constexpr const char* name = "srtf";
+    KeyedHeap ready;
+
+    void reset(const ProcessTable&){ ready.clear(); }
+    void admit(const ProcessTable& procs, int i, double){ ready.push(procs.remaining[i], procs, i); }
+    int pick(const ProcessTable&, double){ return ready.empty() ? -1 : ready.pop(); }
+    int steal(const ProcessTable&){ return ready.empty() ? -1 : ready.pop(); } // a heap only gives up its top
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable& procs, int i, double, bool){ ready.push(procs.remaining[i], procs, i); }
+    void finish(int){}
+};
+
+// Static priority (preemptive). Higher io_weight means higher priority, the
+// classic interactive-first rule; equal weights fall back to index order.
+struct PriorityPolicy {
+    static constexpr const char* name = "priority";
+    KeyedHeap ready;
+
+    void reset(const ProcessTable&){ ready.clear(); }
+    void admit(const ProcessTable& procs, int i, double){ ready.push(-procs.io_weight[i], procs, i); }
+    int pick(const ProcessTable&, double){ return ready.empty() ? -1 : ready.pop(); }
+    int steal(const ProcessTable&){ return ready.empty() ? -1 : ready.pop(); }
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable& procs, int i, double, bool){ ready.push(-procs.io_weight[i], procs, i); }
+    void finish(int){}
+};
+
+// Multi-level feedback queue: LEVELS round-robin queues with the slice
+// doubling per level. A job that uses its whole slice is demoted; every
+// BOOST_MS all jobs move back to the top level so nothing starves.
+struct MlfqPolicy {
+    static constexpr const char* name = "mlfq";
+    static const int LEVELS = 3;
+    static constexpr double BOOST_MS = 1000.0;
+    deque<int> levels[LEVELS]; // a queued job's level is the queue it sits in
+    int running_level = 0;     // level of the job last picked
+    double last_boost = 0.0;
+
+    void reset(const ProcessTable&){
+        for(auto &q: levels) q.clear();
+        running_level = 0;
+        last_boost = 0.0;
+    }
+    void admit(const ProcessTable&, int i, double){ levels[0].push_back(i); }
+    int pick(const ProcessTable&, double now){
+        if(now - last_boost >= BOOST_MS){
+            for(int l=1;l<LEVELS;++l){
+                levels[0].insert(levels[0].end(), levels[l].begin(), levels[l].end());
+                levels[l].clear();
+            }
+            last_boost = now;
+        }
+        for(int l=0;l<LEVELS;++l) if(!levels[l].empty()){
+            int i = levels[l].front(); levels[l].pop_front();
+            running_level = l;
+            return i;
+        }
+        return -1;
+    }
+    int steal(const ProcessTable&){ // the last job of the lowest level that has any
+        for(int l=LEVELS-1;l>=0;--l) if(!levels[l].empty()){
+            int i = levels[l].back(); levels[l].pop_back(); return i;
+        }
+        return -1;
+    }
+    double slice(int, double quantum) const { return quantum * (1 << running_level); }
+    void requeue(const ProcessTable&, int i, double, bool full_slice){
+        if(full_slice && running_level < LEVELS-1) running_level++;
+        levels[running_level].push_back(i);
+    }
+    void finish(int){}
+};
+
+// CFS-like fair share: run the job with the least virtual runtime (wall time
+// spent on the CPU). Newcomers start at the current minimum so they cannot
+// monopolise the CPU to catch up.
+struct CfsPolicy {
+    static constexpr const char* name = "cfs";
+    set<tuple<double,int,int>> timeline; // (vruntime, pid, index)
+    double running_vruntime = 0.0;       // of the job last picked
+    double min_vruntime = 0.0;
+
+    void reset(const ProcessTable&){
+        timeline.clear();
+        running_vruntime = min_vruntime = 0.0;
+    }
+    // migrated jobs also restart at this queue's minimum, as on a real CPU switch
+    void admit(const ProcessTable& procs, int i, double){ timeline.insert({min_vruntime, procs.pid[i], i}); }
+    int pick(const ProcessTable&, double){
+        if(timeline.empty()) return -1;
+        auto it = timeline.begin();
+        int i = get<2>(*it);
+        running_vruntime = get<0>(*it);
+        min_vruntime = max(min_vruntime, running_vruntime);
+        timeline.erase(it);
+        return i;
+    }
+    int steal(const ProcessTable&){ // the job with the most runtime, least entitled to stay
+        if(timeline.empty()) return -1;
+        auto it = prev(timeline.end());
+        int i = get<2>(*it);
+        timeline.erase(it);
+        return i;
+    }
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable& procs, int i, double ran, bool){
+        timeline.insert({running_vruntime + ran, procs.pid[i], i});
+    }
+    void finish(int){}
+};
+
+// Earliest deadline first (preemptive). The relative deadline is
+// DEADLINE_FACTOR times the job's ideal wall time, burst / (1 - io_weight).
+struct EdfPolicy {
+    static constexpr const char* name = "edf";
+    static constexpr double DEADLINE_FACTOR = 2.0;
+    KeyedHeap ready;
+
+    static double deadline(const ProcessTable& procs, int i){
+        return procs.arrival[i] + DEADLINE_FACTOR * procs.burst[i] / max(1.0 - procs.io_weight[i], 1e-9);
+    }
+    void reset(const ProcessTable&){ ready.clear(); }
+    void admit(const ProcessTable& procs, int i, double){ ready.push(deadline(procs, i), procs, i); }
+    int pick(const ProcessTable&, double){ return ready.empty() ? -1 : ready.pop(); }
+    int steal(const ProcessTable&){ return ready.empty() ? -1 : ready.pop(); }
+    double slice(int, double quantum) const { return quantum; }
+    void requeue(const ProcessTable& procs, int i, double, bool){ ready.push(deadline(procs, i), procs, i); }
+    void finish(int){}
+};
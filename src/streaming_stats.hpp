@@ -0,0 +1,141 @@
+// src/streaming_stats.hpp
+// Incremental statistics over a time series that only ever grows at the
+// tail. Each structure is updated once per appended sample, so analysis
+// ticks read their result in O(1) instead of rescanning the series.
+#pragma once
+#include "process.hpp"
+
+// Sliding-window means over several window lengths at once. Points are kept
+// in one deque sized for the longest window; every window keeps its own
+// start cursor and running sum (Neumaier-compensated, so adding and evicting
+// for hours does not drift). A point belongs to a window while
+// now - time <= len, where now is the newest point's time, the same rule
+// as Analyzer::moving_avg.
+struct SlidingWindows {
+    struct Window {
+        double len;
+        size_t start = 0; // absolute index of the oldest point inside
+        double sum = 0, comp = 0;
+    };
+    deque<SeriesPoint> pts;
+    size_t base = 0; // absolute index of pts.front()
+    vector<Window> windows;
+
+    // registers a window and returns its id; call before adding points
+    int add_window(double len){
+        for(size_t i=0;i<windows.size();++i) if(windows[i].len == len) return (int)i;
+        Window w; w.len = len; w.start = base + pts.size();
+        windows.push_back(w);
+        return (int)windows.size()-1;
+    }
+    void clear(){
+        pts.clear(); base = 0;
+        for(auto &w: windows){ w.start = 0; w.sum = w.comp = 0; }
+    }
+    void add(const SeriesPoint& p){
+        pts.push_back(p);
+        size_t newest = base + pts.size() - 1, oldest = newest;
+        for(auto &w: windows){
+            accumulate(w, p.value);
+            while(w.start <= newest && p.time - at(w.start).time > w.len){ accumulate(w, -at(w.start).value); w.start++; }
+            oldest = min(oldest, w.start);
+        }
+        while(base < oldest){ pts.pop_front(); base++; }
+    }
+    size_t count(int id) const { return base + pts.size() - windows[id].start; }
+    double mean(int id) const {
+        size_t n = count(id);
+        return n ? (windows[id].sum + windows[id].comp) / n : 0.0;
+    }
+
+private:
+    const SeriesPoint& at(size_t abs_index) const { return pts[abs_index - base]; }
+    static void accumulate(Window& w, double v){
+        double t = w.sum + v;
+        if(fabs(w.sum) >= fabs(v)) w.comp += (w.sum - t) + v;
+        else w.comp += (v - t) + w.sum;
+        w.sum = t;
+    }
+};
+
+// Least-squares line over the last `capacity` points, updated in O(1) per
+// point. Keeps Welford-style centred moments (means plus sums of centred
+// squares and cross products) rather than raw sums, with times measured from
+// a reference that follows the window, so wide windows and large timestamps
+// do not cancel catastrophically. The moments are rebuilt from the retained
+// points once per `capacity` evictions, which bounds add/evict drift at O(1)
+// amortized cost, and whenever an eviction cancels almost all of the spread
+// in y. result() matches Analyzer::linear_regression_offset.
+struct IncrementalRegression {
+    static const int MIN_POINTS_FOR_REG = 5;
+    size_t capacity;
+    deque<SeriesPoint> pts;
+    double t_ref = 0;           // x = time - t_ref
+    double mx = 0, my = 0;      // means
+    double sxx = 0, sxy = 0, syy = 0; // centred moments
+    size_t evictions = 0;
+
+    explicit IncrementalRegression(size_t cap = 10) : capacity(max<size_t>(cap, 1)) {}
+
+    void clear(){ pts.clear(); t_ref = mx = my = sxx = sxy = syy = 0; evictions = 0; }
+    void add(const SeriesPoint& p){
+        if(pts.empty()) t_ref = p.time;
+        pts.push_back(p);
+        push(p.time - t_ref, p.value);
+        if(pts.size() > capacity){
+            SeriesPoint old = pts.front(); pts.pop_front();
+            double prev_syy = syy;
+            if(++evictions >= capacity) rebuild();
+            else {
+                pop(old.time - t_ref, old.value);
+                // the window just went (nearly) flat: the subtraction cancelled and left
+                // only rounding noise, which would show up as a +-1e-13 slope
+                if(syy < 1e-9 * prev_syy) rebuild();
+            }
+        }
+    }
+    size_t size() const { return pts.size(); }
+    // (slope, fitted value at the newest point), with the same fallbacks as the batch fit
+    pair<double,double> result() const {
+        size_t n = pts.size();
+        if(n < (size_t)MIN_POINTS_FOR_REG) return {0.0, pts.empty() ? 0.0 : pts.back().value};
+        if(fabs(n * sxx) < 1e-9) return {0.0, my};
+        double m = sxy / sxx;
+        double last_x = pts.back().time - t_ref;
+        return {m, my + m * (last_x - mx)};
+    }
+
+private:
+    void push(double x, double y){
+        size_t n = pts.size();
+        double dx = x - mx, old_my = my;
+        mx += dx / n;
+        my += (y - my) / n;
+        sxx += dx * (x - mx);
+        sxy += dx * (y - my);
+        syy += (y - old_my) * (y - my);
+    }
+    void pop(double x, double y){
+        size_t n = pts.size(); // count after removal, >= 1
+        double old_mx = mx, old_my = my;
+        mx -= (x - mx) / n;
+        my -= (y - my) / n;
+        sxx -= (x - mx) * (x - old_mx);
+        sxy -= (x - mx) * (y - old_my);
+        syy -= (y - my) * (y - old_my);
+    }
+    // exact two-pass recompute, re-centred on the oldest retained point
+    void rebuild(){
+        evictions = 0;
+        t_ref = pts.front().time;
+        size_t n = pts.size();
+        mx = my = 0;
+        for(auto &p: pts){ mx += p.time - t_ref; my += p.value; }
+        mx /= n; my /= n;
+        sxx = sxy = syy = 0;
+        for(auto &p: pts){
+            double dx = p.time - t_ref - mx, dy = p.value - my;
+            sxx += dx*dx; sxy += dx*dy; syy += dy*dy;
+        }
+    }
+};
@@ -0,0 +1,47 @@
+// src/thread_pool.hpp
+// Fork-join helper for running independent simulations in parallel.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+inline unsigned default_threads(){ return max(1u, thread::hardware_concurrency()); }
+
+// Calls fn(i) for every i in [0, n) on up to `threads` workers with work
+// stealing: items are dealt round-robin into per-worker deques, each worker
+// takes from the back of its own deque and, once that is empty, steals from
+// the front of the others'. Simulations vary by orders of magnitude in cost
+// (trace size, quantum), so a worker that drew short jobs keeps helping
+// instead of idling. fn must not throw.
+template<class F>
+void parallel_for(size_t n, unsigned threads, F fn){
+    threads = (unsigned)min<size_t>(max(1u, threads), max<size_t>(n, 1));
+    struct Queue { mutex mu; deque<size_t> items; };
+    vector<Queue> queues(threads);
+    for(size_t i=0;i<n;++i) queues[i % threads].items.push_back(i);
+
+    auto take_own = [&](unsigned w, size_t& item){
+        lock_guard<mutex> lk(queues[w].mu);
+        if(queues[w].items.empty()) return false;
+        item = queues[w].items.back(); queues[w].items.pop_back();
+        return true;
+    };
+    auto steal = [&](unsigned w, size_t& item){
+        for(unsigned k=1;k<threads;++k){
+            Queue &victim = queues[(w + k) % threads];
+            lock_guard<mutex> lk(victim.mu);
+            if(victim.items.empty()) continue;
+            item = victim.items.front(); victim.items.pop_front();
+            return true;
+        }
+        return false;
+    };
+    // nothing is ever added after dealing, so "all deques empty" means done
+    auto worker = [&](unsigned w){
+        size_t item;
+        while(take_own(w, item) || steal(w, item)) fn(item);
+    };
+    vector<thread> pool;
+    for(unsigned t=1;t<threads;++t) pool.emplace_back(worker, t);
+    worker(0); // the calling thread works too
+    for(auto &th: pool) th.join();
+}
@@ -0,0 +1,58 @@
+// src/time_series.hpp
+// Bounded storage for the simulator's sampled series. RingSeries keeps the
+// recent samples in a fixed-capacity ring, dropping points older than the
+// retention horizon, so memory no longer grows with the length of the run.
+// An optional archive tier folds every sample into fixed-width time buckets
+// (min/max/mean), which is enough to plot a whole run at low resolution.
+#pragma once
+#include "process.hpp"
+
+struct SeriesBucket {
+    double start; // bucket start time, ms
+    double min, max, sum;
+    size_t count;
+    double mean() const { return count ? sum / count : 0.0; }
+};
+
+struct RingSeries {
+    vector<SeriesPoint> buf;
+    size_t head = 0, n = 0;   // oldest point is buf[head]
+    double horizon_ms;        // keep points with newest.time - time <= horizon_ms
+    double bucket_ms = 0;     // archive bucket width, 0 = no archive
+    vector<SeriesBucket> archive;
+
+    explicit RingSeries(size_t capacity = 4096, double horizon = 1e18)
+      : buf(max<size_t>(capacity, 1)), horizon_ms(horizon) {}
+
+    // resizes the ring (dropping its contents) and sets the retention horizon
+    void configure(size_t capacity, double horizon){
+        buf.assign(max<size_t>(capacity, 1), SeriesPoint{0, 0});
+        horizon_ms = horizon;
+        head = n = 0;
+    }
+    void enable_archive(double bucket_width_ms){ bucket_ms = bucket_width_ms; archive.clear(); }
+    void clear(){ head = n = 0; archive.clear(); }
+
+    void push_back(const SeriesPoint& p){
+        if(bucket_ms > 0) archive_add(p);
+        size_t cap = buf.size();
+        if(n == cap){ buf[head] = p; head = (head + 1) % cap; }
+        else buf[(head + n++) % cap] = p;
+        while(n > 1 && p.time - buf[head].time > horizon_ms){ head = (head + 1) % cap; n--; }
+    }
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    const SeriesPoint& operator[](size_t i) const { return buf[(head + i) % buf.size()]; }
+    const SeriesPoint& front() const { return buf[head]; }
+    const SeriesPoint& back() const { return (*this)[n - 1]; }
+
+private:
+    void archive_add(const SeriesPoint& p){
+        double start = floor(p.time / bucket_ms) * bucket_ms;
+        if(archive.empty() || archive.back().start != start)
+            archive.push_back({start, p.value, p.value, 0.0, 0});
+        SeriesBucket &b = archive.back();
+        b.min = min(b.min, p.value); b.max = max(b.max, p.value);
+        b.sum += p.value; b.count++;
+    }
+};
@@ -0,0 +1,393 @@
+// src/trace_reader.hpp
+// Trace input. Text traces have one job per line, "arrival burst mem_kb
+// io_weight", whitespace separated; the file is memory-mapped and tokenized
+// in place with from_chars (no iostreams, no locale), and malformed rows are
+// reported with their line and column. Binary traces (see BinaryTrace) are
+// mapped and read in place; their rows are reported by index. Values are
+// checked the same way in both (see trace_value_error). Both kinds are
+// detected by content, not extension.
+#pragma once
+#include "process.hpp"
+#include "instrument.hpp"
+#ifdef _WIN32
+// no min/max macros (this code calls min/max unqualified) and less of the
+// API. windows.h still defines far, near and CONST as macros, so names in
+// this tree avoid them.
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only mapping of a whole file. An empty file maps to size 0.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#endif
+
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){ close(); }
+
+    bool open(const string& path){
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER len;
+        if(!GetFileSizeEx(file, &len)){ close(); return false; }
+        size = (size_t)len.QuadPart;
+        if(size == 0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(!mapping){ close(); return false; }
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(!data){ close(); return false; }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+        struct stat st;
+        if(fstat(fd, &st) != 0){ ::close(fd); return false; }
+        size = (size_t)st.st_size;
+        if(size > 0){
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p == MAP_FAILED){ ::close(fd); size = 0; return false; }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = (const char*)p;
+        }
+        ::close(fd); // the mapping stays valid
+#endif
+        return true;
+    }
+    void close(){
+#ifdef _WIN32
+        if(data) UnmapViewOfFile(data);
+        if(mapping) CloseHandle(mapping);
+        if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr; file = INVALID_HANDLE_VALUE;
+#else
+        if(data) munmap((void*)data, size);
+#endif
+        data = nullptr; size = 0;
+    }
+};
+
+struct TraceRow { double arrival, burst, mem_kb, io_weight; };
+
+static const char* const TRACE_COLUMNS[4] = {"arrival", "burst", "mem_kb", "io_weight"};
+
+// why v cannot go in trace column col, or "" if it can. Non-finite values
+// break the event queue's ordering, and io_weight 1 would never finish its
+// burst; arrivals must stay below the 1e18 "no more arrivals" sentinel.
+inline string trace_value_error(int col, double v){
+    string name = TRACE_COLUMNS[col];
+    if(!isfinite(v)) return "non-finite " + name;
+    if(col == 0 && v >= 1e18) return name + " out of range (must be below 1e18)";
+    if((col == 1 || col == 2) && v < 0) return "negative " + name;
+    if(col == 3 && !(v >= 0 && v < 1)) return name + " out of range (must be in [0,1))";
+    return "";
+}
+
+// Zero-copy tokenizer over a mapped trace. Blank lines are skipped; anything
+// else must be exactly four numbers (one leading '+' allowed, as operator>>
+// did), each within trace_value_error's limits.
+struct TraceParser {
+    MappedFile file;
+    string path;
+    const char *p = nullptr, *end = nullptr, *line_start = nullptr;
+    long long line = 0;
+    long long row_line = 0, row_col = 0; // where the last row returned by next() starts
+
+    bool open(const string& path_){
+        path = path_;
+        if(!file.open(path)) return false;
+        p = line_start = file.data; end = file.data + file.size;
+        line = 1;
+        return true;
+    }
+    // fills row and returns true, or returns false at end of file; throws on a malformed row
+    bool next(TraceRow& row){
+        AIPO_PROF_SCOPE("trace.parse_row");
+        for(;;){
+            skip_blanks();
+            if(p == end) return false;
+            if(*p == '\n' || *p == '\r'){ new_line(); continue; }
+            break;
+        }
+        row_line = line; row_col = p - line_start + 1;
+        row.arrival = field(0);
+        row.burst = field(1);
+        row.mem_kb = field(2);
+        row.io_weight = field(3);
+        skip_blanks();
+        if(p != end && *p != '\n' && *p != '\r') fail("unexpected extra field");
+        return true;
+    }
+    [[noreturn]] void fail(const string& what) const {
+        throw runtime_error(path + ":" + to_string(line) + ":" + to_string(p - line_start + 1) + ": " + what);
+    }
+    // an error in the last row as a whole, reported at its first field
+    [[noreturn]] void fail_row(const string& what) const {
+        throw runtime_error(path + ":" + to_string(row_line) + ":" + to_string(row_col) + ": " + what);
+    }
+
+private:
+    void skip_blanks(){ while(p != end && (*p == ' ' || *p == '\t')) ++p; }
+    void new_line(){
+        if(*p == '\r' && p+1 != end && p[1] == '\n') ++p;
+        ++p; line_start = p; ++line;
+    }
+    // the number in column col; errors point at its first character
+    double field(int col){
+        skip_blanks();
+        const char* name = TRACE_COLUMNS[col];
+        if(p == end || *p == '\n' || *p == '\r') fail(string("missing ") + name);
+        double v;
+        bool plus = *p == '+'; // from_chars takes no sign but '-'
+        auto r = from_chars(p + plus, end, v);
+        if(r.ec != errc() || (plus && p[1] == '-') || (r.ptr != end && !isspace((unsigned char)*r.ptr)))
+            fail(string("bad number for ") + name);
+        string bad = trace_value_error(col, v);
+        if(!bad.empty()) fail(bad);
+        p = r.ptr;
+        return v;
+    }
+};
+
+// Binary columnar trace, version 1 (little-endian):
+//   BinTraceHeader (24 bytes), then `count` doubles each of arrival, burst,
+//   mem_kb and io_weight, one column after the other.
+// Every column starts 8-byte aligned, so a mapping can be read in place.
+struct BinTraceHeader {
+    char magic[8];     // "AIPOBIN" + NUL
+    uint32_t version;  // BIN_TRACE_VERSION
+    uint32_t columns;  // 4
+    uint64_t count;    // rows
+};
+static_assert(sizeof(BinTraceHeader) == 24, "BinTraceHeader must stay 24 bytes");
+static const char BIN_TRACE_MAGIC[8] = {'A','I','P','O','B','I','N','\0'};
+static const uint32_t BIN_TRACE_VERSION = 1;
+
+inline bool is_binary_trace(const MappedFile& f){
+    return f.size >= sizeof(BinTraceHeader) && memcmp(f.data, BIN_TRACE_MAGIC, 8) == 0;
+}
+
+// Read-only view of a mapped binary trace; the column pointers alias the mapping.
+struct BinaryTrace {
+    MappedFile file;
+    string file_path;
+    uint64_t count = 0;
+    const double *arrival = nullptr, *burst = nullptr, *mem_kb = nullptr, *io_weight = nullptr;
+
+    bool open(const string& path){
+        if(!file.open(path)) return false;
+        file_path = path;
+        if(!is_binary_trace(file)) throw runtime_error(path + ": not a binary trace");
+        BinTraceHeader h;
+        memcpy(&h, file.data, sizeof h);
+        if(h.version != BIN_TRACE_VERSION || h.columns != 4)
+            throw runtime_error(path + ": unsupported binary trace version " + to_string(h.version));
+        if(h.count > (file.size - sizeof h) / (4 * sizeof(double)) ||
+           file.size != sizeof h + h.count * 4 * sizeof(double))
+            throw runtime_error(path + ": truncated binary trace");
+        count = h.count;
+        const double* col = (const double*)(file.data + sizeof h);
+        arrival = col; burst = col + count; mem_kb = col + 2*count; io_weight = col + 3*count;
+        return true;
+    }
+    // throws if row i (from 0; reported from 1) holds a value trace_value_error rejects
+    void check_row(uint64_t i) const {
+        const double v[4] = {arrival[i], burst[i], mem_kb[i], io_weight[i]};
+        for(int k=0;k<4;++k){
+            string bad = trace_value_error(k, v[k]);
+            if(!bad.empty()) throw runtime_error(file_path + ": row " + to_string(i+1) + ": " + bad);
+        }
+    }
+};
+
+inline void write_binary_trace(const string& path, const ProcessTable& procs){
+    ofstream out(path, ios::binary);
+    if(!out) throw runtime_error("Cannot create " + path);
+    BinTraceHeader h;
+    memcpy(h.magic, BIN_TRACE_MAGIC, 8);
+    h.version = BIN_TRACE_VERSION; h.columns = 4; h.count = procs.size();
+    out.write((const char*)&h, sizeof h);
+    for(const vector<double>* col: {&procs.arrival, &procs.burst, &procs.mem_kb, &procs.io_weight})
+        out.write((const char*)col->data(), col->size() * sizeof(double));
+    if(!out) throw runtime_error("Write failed: " + path);
+}
+
+// Row-at-a-time trace output, text or binary, for traces too large to build
+// as a table first (see workload_gen.hpp). A binary trace needs its row
+// count up front: each column is buffered and flushed at its own offset.
+// Text numbers are fixed-point with `decimals` places, trailing zeros trimmed.
+struct TraceWriter {
+    static const size_t BUF_ROWS = 1 << 14;
+    FILE* f = nullptr;
+    string path;
+    bool binary = false;
+    uint64_t count = 0, written = 0, flushed = 0;
+    vector<double> cols[4];
+    string text;
+    int decimals[4] = {3, 2, 0, 3}; // arrival, burst, mem_kb, io_weight
+
+    TraceWriter() {}
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    ~TraceWriter(){ if(f) fclose(f); }
+
+    // binary: count is the exact number of rows that will be added
+    void open(const string& path_, bool binary_, uint64_t count_){
+        path = path_; binary = binary_; count = count_; written = flushed = 0;
+        f = fopen(path.c_str(), "wb");
+        if(!f) throw runtime_error("Cannot create " + path);
+        if(binary){
+            BinTraceHeader h;
+            memcpy(h.magic, BIN_TRACE_MAGIC, 8);
+            h.version = BIN_TRACE_VERSION; h.columns = 4; h.count = count;
+            fwrite(&h, sizeof h, 1, f);
+            for(auto &c: cols){ c.clear(); c.reserve(BUF_ROWS); }
+        } else text.reserve(BUF_ROWS * 40);
+    }
+    void add(const TraceRow& r){
+        written++;
+        double v[4] = {r.arrival, r.burst, r.mem_kb, r.io_weight};
+        if(binary){
+            for(int k=0;k<4;++k) cols[k].push_back(v[k]);
+            if(cols[0].size() == BUF_ROWS) flush_columns();
+            return;
+        }
+        for(int k=0;k<4;++k){
+            char buf[64];
+            auto res = to_chars(buf, buf + sizeof buf, v[k], chars_format::fixed, decimals[k]);
+            char* e = res.ec == errc() ? res.ptr : to_chars(buf, buf + sizeof buf, v[k]).ptr;
+            if(res.ec == errc() && decimals[k] > 0){ while(e[-1] == '0') --e; if(e[-1] == '.') --e; }
+            text.append(buf, e);
+            text += k < 3 ? ' ' : '\n';
+        }
+        if(text.size() >= BUF_ROWS * 32){ fwrite(text.data(), 1, text.size(), f); text.clear(); }
+    }
+    void close(){
+        if(!f) return;
+        if(binary) flush_columns(); else fwrite(text.data(), 1, text.size(), f);
+        text.clear();
+        bool ok = !ferror(f);
+        ok &= fclose(f) == 0;
+        f = nullptr;
+        if(!ok) throw runtime_error("Write failed: " + path);
+        if(binary && written != count)
+            throw runtime_error(path + ": wrote " + to_string(written) + " rows, header says " + to_string(count));
+    }
+
+private:
+    void flush_columns(){
+        size_t n = cols[0].size();
+        if(n == 0) return;
+        if(flushed + n > count) throw runtime_error(path + ": more rows than the header count");
+        for(int k=0;k<4;++k){
+            seek(sizeof(BinTraceHeader) + (k * count + flushed) * sizeof(double));
+            fwrite(cols[k].data(), sizeof(double), n, f);
+            cols[k].clear();
+        }
+        flushed += n;
+    }
+    void seek(uint64_t pos){
+#ifdef _WIN32
+        _fseeki64(f, (long long)pos, SEEK_SET);
+#else
+        fseeko(f, (off_t)pos, SEEK_SET);
+#endif
+    }
+};
+
+inline bool file_is_binary_trace(const string& path){
+    MappedFile f;
+    return f.open(path) && is_binary_trace(f);
+}
+
+// Reads a whole trace, text or binary, into a fresh process table (batch
+// mode). Binary rows are checked, then the columns are copied straight into
+// the table's arrays.
+inline void load_trace(const string& path, ProcessTable& procs){
+    AIPO_PROF_SCOPE("trace.load");
+    procs.clear();
+    if(file_is_binary_trace(path)){
+        BinaryTrace bt;
+        bt.open(path);
+        size_t n = bt.count;
+        for(size_t i=0;i<n;++i) bt.check_row(i);
+        procs.arrival.assign(bt.arrival, bt.arrival + n);
+        procs.burst.assign(bt.burst, bt.burst + n);
+        procs.remaining.assign(bt.burst, bt.burst + n);
+        procs.mem_kb.assign(bt.mem_kb, bt.mem_kb + n);
+        procs.io_weight.assign(bt.io_weight, bt.io_weight + n);
+        procs.cpu_consumed.assign(n, 0.0);
+        procs.start_time.assign(n, -1.0);
+        procs.finish_time.assign(n, -1.0);
+        procs.pid.resize(n);
+        iota(procs.pid.begin(), procs.pid.end(), 1);
+        return;
+    }
+    TraceParser tp;
+    if(!tp.open(path)) throw runtime_error("Cannot open " + path);
+    TraceRow r; int id=1;
+    while(tp.next(r)) procs.push_back(Process(id++, r.arrival, r.burst, r.mem_kb, r.io_weight));
+}
+
+// Streaming reader: rows are pulled one at a time with a single row of
+// lookahead, so the simulator's memory does not grow with the trace. The
+// trace must be sorted by arrival.
+struct TraceStream {
+    string path;
+    TraceParser parser;
+    BinaryTrace bin;
+    bool binary = false;
+    uint64_t bin_pos = 0;
+    bool has_row = false;
+    TraceRow row{}; // lookahead
+    long long rows = 0;
+
+    bool open(const string& p){
+        path = p;
+        binary = file_is_binary_trace(p);
+        if(binary ? !bin.open(p) : !parser.open(p)) return false;
+        rows = 0; bin_pos = 0;
+        has_row = read_row();
+        return true;
+    }
+    bool pending() const { return has_row; }
+    double next_arrival() const { return has_row ? row.arrival : 1e18; }
+    // hands out the lookahead row as a process with the next pid and reads ahead
+    Process take(){
+        Process p((int)++rows, row.arrival, row.burst, row.mem_kb, row.io_weight);
+        has_row = read_row();
+        if(has_row && row.arrival < p.arrival){
+            const char* what = "arrives before the previous row; streaming needs an arrival-sorted trace";
+            if(binary) throw runtime_error(path + ": row " + to_string(rows+1) + " " + what);
+            parser.fail_row(what);
+        }
+        return p;
+    }
+
+private:
+    bool read_row(){
+        if(!binary) return parser.next(row);
+        if(bin_pos == bin.count) return false;
+        AIPO_PROF_COUNT("trace.binary_rows", 1);
+        bin.check_row(bin_pos);
+        row = {bin.arrival[bin_pos], bin.burst[bin_pos], bin.mem_kb[bin_pos], bin.io_weight[bin_pos]};
+        bin_pos++;
+        return true;
+    }
+};
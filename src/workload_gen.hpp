@@ -0,0 +1,131 @@
+// src/workload_gen.hpp
+// Seeded synthetic workloads for scale testing. Jobs arrive as a Poisson
+// process whose rate can follow a daily (sinusoidal) curve; burst, memory
+// and io_weight are drawn from configurable distributions. Rows come out
+// one at a time in arrival order, so traces of any size stream straight to
+// disk (text or binary) and can be replayed with --stream.
+#pragma once
+#include "trace_reader.hpp"
+
+// The seeded source behind every sample. mt19937_64's output is fixed by the
+// standard but the <random> distributions are not (libstdc++, libc++ and MSVC
+// differ), so uniforms, exponentials and normals are derived here from the
+// raw 64-bit draws: a seed names the same workload with any standard library,
+// up to last-bit differences in log/sin/cos that the output rounding absorbs.
+struct WorkloadRng {
+    mt19937_64 eng;
+    bool has_spare = false;
+    double spare = 0; // second normal of the last Box-Muller pair
+    explicit WorkloadRng(uint64_t seed) : eng(seed) {}
+    double uniform(){ return (double)(eng() >> 11) * 0x1.0p-53; } // [0, 1), 53 random bits
+    double exponential(double mean){ return -mean * log(1 - uniform()); } // inverse CDF
+    double normal(){ // standard normal, Box-Muller
+        if(has_spare){ has_spare = false; return spare; }
+        double r = sqrt(-2 * log(1 - uniform())), th = 2 * acos(-1.0) * uniform();
+        spare = r * sin(th); has_spare = true;
+        return r * cos(th);
+    }
+};
+
+// One column's distribution, parsed from "kind:a,b,...":
+//   const:v            uniform:lo,hi        exp:mean
+//   normal:mean,sd     lognormal:mu,sigma   pareto:alpha,lo,hi (bounded, heavy-tailed)
+//   bimodal:p,m1,s1,m2,s2   normal m1/s1 with probability p, else m2/s2
+//   iomix:p_cpu,p_io   io_weight classes: CPU-bound U(0,0.2) with p_cpu,
+//                      IO-bound U(0.6,0.95) with p_io, else Mixed U(0.2,0.6)
+struct Dist {
+    enum Kind { DIST_CONST, DIST_UNIFORM, DIST_EXP, DIST_NORMAL, DIST_LOGNORMAL, DIST_PARETO, DIST_BIMODAL, DIST_IOMIX };
+    Kind kind = DIST_CONST;
+    vector<double> a = {0};
+
+    static Dist parse(const string& spec){
+        static const map<string,pair<Kind,size_t>> kinds = {{"const",{DIST_CONST,1}}, {"uniform",{DIST_UNIFORM,2}},
+            {"exp",{DIST_EXP,1}}, {"normal",{DIST_NORMAL,2}}, {"lognormal",{DIST_LOGNORMAL,2}}, {"pareto",{DIST_PARETO,3}},
+            {"bimodal",{DIST_BIMODAL,5}}, {"iomix",{DIST_IOMIX,2}}};
+        Dist d;
+        size_t colon = spec.find(':');
+        string name = spec.substr(0, colon);
+        auto it = kinds.find(name);
+        if(it == kinds.end()) throw runtime_error("unknown distribution '" + name + "'");
+        d.kind = it->second.first;
+        d.a.clear();
+        if(colon != string::npos){
+            stringstream ss(spec.substr(colon + 1)); string v;
+            while(getline(ss, v, ',')){
+                char* e; double x = strtod(v.c_str(), &e);
+                if(v.empty() || *e) throw runtime_error("bad number '" + v + "' in " + spec);
+                d.a.push_back(x);
+            }
+        }
+        if(d.a.size() != it->second.second)
+            throw runtime_error(spec + ": " + name + " takes " + to_string(it->second.second) + " parameters");
+        if(d.kind == DIST_PARETO && !(d.a[0] > 0 && d.a[1] > 0 && d.a[2] > d.a[1]))
+            throw runtime_error(spec + ": pareto needs alpha > 0 and 0 < lo < hi");
+        if(d.kind == DIST_EXP && !(d.a[0] > 0)) throw runtime_error(spec + ": exp needs mean > 0");
+        if(((d.kind == DIST_NORMAL || d.kind == DIST_LOGNORMAL) && !(d.a[1] > 0)) || (d.kind == DIST_BIMODAL && !(d.a[2] > 0 && d.a[4] > 0)))
+            throw runtime_error(spec + ": standard deviations must be > 0");
+        return d;
+    }
+
+    double sample(WorkloadRng& rng) const {
+        switch(kind){
+        case DIST_CONST: return a[0];
+        case DIST_UNIFORM: return a[0] + (a[1] - a[0]) * rng.uniform();
+        case DIST_EXP: return rng.exponential(a[0]);
+        case DIST_NORMAL: return a[0] + a[1] * rng.normal();
+        case DIST_LOGNORMAL: return exp(a[0] + a[1] * rng.normal());
+        case DIST_PARETO: { // inverse CDF of the Pareto truncated to [lo, hi]
+            double alpha = a[0], lo = a[1], hi = a[2];
+            return lo / pow(1 - rng.uniform() * (1 - pow(lo / hi, alpha)), 1 / alpha);
+        }
+        case DIST_BIMODAL: {
+            bool first = rng.uniform() < a[0];
+            return (first ? a[1] : a[3]) + (first ? a[2] : a[4]) * rng.normal();
+        }
+        case DIST_IOMIX: {
+            double r = rng.uniform();
+            if(r < a[0]) return 0.2 * rng.uniform();
+            if(r < a[0] + a[1]) return 0.6 + 0.35 * rng.uniform();
+            return 0.2 + 0.4 * rng.uniform();
+        }
+        }
+        return 0;
+    }
+};
+
+struct WorkloadSpec {
+    uint64_t count = 1000;
+    uint64_t seed = 1;
+    double rate = 0.05;           // mean arrivals per ms
+    double diurnal = 0;           // 0..1: rate swings by this fraction over each period
+    double period_ms = 86400000;  // one simulated day
+    Dist burst = Dist::parse("pareto:1.5,5,5000");
+    Dist mem = Dist::parse("bimodal:0.8,8000,3000,200000,50000");
+    Dist io = Dist::parse("iomix:0.5,0.3");
+};
+
+// Rows in arrival order. The diurnal curve rate * (1 + diurnal * sin(2 pi t /
+// period)) is sampled by thinning: candidates at the peak rate, each kept
+// with probability rate(t) / peak. Values are rounded to what the text
+// format keeps, so a text and a binary trace of one spec are identical.
+struct WorkloadGen {
+    WorkloadSpec spec;
+    WorkloadRng rng;
+    double t = 0;
+    uint64_t emitted = 0;
+
+    explicit WorkloadGen(const WorkloadSpec& s) : spec(s), rng(s.seed) {}
+
+    bool next(TraceRow& r){
+        if(emitted == spec.count) return false;
+        double peak = spec.rate * (1 + spec.diurnal);
+        do t += rng.exponential(1 / peak);
+        while(spec.diurnal > 0 && rng.uniform() * (1 + spec.diurnal) > 1 + spec.diurnal * sin(2 * acos(-1.0) * t / spec.period_ms));
+        r.arrival = round(t * 1000) / 1000;
+        r.burst = max(0.01, round(spec.burst.sample(rng) * 100) / 100);
+        r.mem_kb = max(0.0, round(spec.mem.sample(rng)));
+        r.io_weight = min(0.99, max(0.0, round(spec.io.sample(rng) * 1000) / 1000));
+        emitted++;
+        return true;
+    }
+};